@@ -0,0 +1,20 @@
+/*
+ * Space Invaders - C Allocator Call Counter
+ * Shared object preloaded for --check-alloc (LD_PRELOAD=build/alloc_count.so)
+ * that counts every call into the C allocator, libraries included. Nothing
+ * links it: the game looks the counter up by name at run time.
+ */
+
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <stdint.h>
+
+/* Name the counter is exported under */
+#define ALLOC_COUNT_SYMBOL "alloc_count_calls"
+
+/* malloc, calloc, realloc and aligned allocation calls so far, by any
+ * thread; read with __atomic_load_n. Defined only in the shim. */
+extern uint64_t alloc_count_calls;
+
+#endif /* ALLOC_COUNT_H */
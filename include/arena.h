@@ -0,0 +1,88 @@
+/*
+ * Space Invaders - Arena Allocator Header
+ * Bump allocator owning the memory of one game session, plus process-wide
+ * allocation counters for checking that frames never allocate
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Alignment of the arena buffer and of every arena allocation (one cache line) */
+#define ARENA_ALIGN 64
+
+/* One heap block carved front to back. Allocations below `keep` live as long
+ * as the arena; the ones above it are released together by arena_reset. */
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;  /* bump offset */
+    size_t keep;  /* offset arena_reset returns to */
+} Arena;
+
+/* Allocation counters for the whole process */
+typedef struct {
+    uint64_t heap_allocs;   /* blocks taken from the heap (arenas included) */
+    uint64_t heap_bytes;
+    uint64_t arena_allocs;  /* allocations served from arenas */
+    uint64_t arena_bytes;
+} AllocStats;
+
+/**
+ * Create an arena of `capacity` bytes in one heap block
+ * Returns NULL on error
+ */
+Arena* arena_create(size_t capacity);
+
+/**
+ * Free an arena and everything allocated from it
+ */
+void arena_free(Arena *arena);
+
+/**
+ * Allocate `size` bytes aligned to ARENA_ALIGN; never touches the heap
+ * Returns NULL when the arena is full
+ */
+void* arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Keep everything allocated so far across arena_reset (session objects)
+ */
+void arena_keep(Arena *arena);
+
+/**
+ * Release every allocation made since the last arena_keep
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * Counted heap allocation, for long-lived memory that lives outside any
+ * arena (rings, replay buffers); released with arena_heap_free
+ * Returns NULL on error
+ */
+void* arena_heap_alloc(size_t size);
+
+/**
+ * Zero-filled arena_heap_alloc
+ */
+void* arena_heap_calloc(size_t size);
+
+/**
+ * Free a block from arena_heap_alloc/arena_heap_calloc
+ */
+void arena_heap_free(void *block);
+
+/**
+ * Heap plus arena allocations made so far; a frame allocated if this moved
+ * across it (cheap enough to sample every frame)
+ */
+uint64_t arena_alloc_count(void);
+
+/**
+ * Snapshot of the allocation counters
+ */
+void arena_stats(AllocStats *stats);
+
+#endif /* ARENA_H */
@@ -0,0 +1,30 @@
+/*
+ * Space Invaders - Benchmarks Header
+ * Micro-benchmarks for the model, run from the command line (--bench NAME)
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Run the named benchmark and print its results to stdout
+ * Returns EXIT_SUCCESS, or EXIT_FAILURE if the name is unknown
+ */
+int bench_run(const char *name);
+
+/**
+ * Print the available benchmark names
+ */
+void bench_list(FILE *out);
+
+/**
+ * Stress mode: step one game `frames` frames on ever larger boards and
+ * formations (runtime GameConfig) and print the per-frame cost at each size
+ * Returns EXIT_SUCCESS, or EXIT_FAILURE if a board cannot be allocated
+ */
+int bench_stress(int frames, uint64_t seed);
+
+#endif /* BENCH_H */
@@ -6,7 +6,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-/* Game board dimensions */
+/* Game board dimensions (defaults; a GameConfig can size the board at runtime) */
 #define BOARD_WIDTH 80
 #define BOARD_HEIGHT 24
 
@@ -14,44 +14,71 @@
 #define PLAYER_WIDTH 3
 #define PLAYER_HEIGHT 1
 #define PLAYER_SPEED 2
+#define PLAYER_MOVE_PERIOD 3  /* Frames between steps while a direction key is held */
 
 /* Enemy properties */
 #define ENEMY_WIDTH 3
 #define ENEMY_HEIGHT 1
-#define MAX_ENEMIES 55
-#define INITIAL_ENEMIES 30
+#define INITIAL_ENEMIES 30   /* Default formation slots */
 #define ENEMY_ROWS 5
 #define ENEMY_COLS 6
+#define ENEMY_START_X 2      /* Formation origin at level start */
+#define ENEMY_START_Y 2
+#define ENEMY_SPACING_X 12   /* Default column/row pitch inside the formation */
+#define ENEMY_SPACING_Y 3
 
 /* Enemy movement */
 #define ENEMY_BASE_SPEED 1
 #define ENEMY_MOVE_DOWN 1
+#define ENEMY_MOVE_PERIOD 9  /* Frames between formation steps at full strength */
 #define ENEMY_SPEED_INCREASE_THRESHOLD 10  /* Speed increases when < 10 enemies remain */
 
 /* Projectile properties */
-#define MAX_PROJECTILES 100
+#define MAX_PROJECTILES 100  /* Default pool capacity */
 #define PROJECTILE_SPEED 3
 
 /* Enemy projectile properties */
-#define MAX_ENEMY_PROJECTILES 30
+#define MAX_ENEMY_PROJECTILES 30  /* Default pool capacity */
 #define ENEMY_PROJECTILE_SPEED 1
 #define ENEMY_FIRE_RATE 50  /* Frames between enemy shots (higher = slower) */
 
-/* Shield properties */
-#define SHIELD_COUNT 4
-#define SHIELD_WIDTH 4
-#define SHIELD_HEIGHT 1
+/* Level pack loaded at startup when present (build it with make levels);
+ * without one every level uses the built-in layout above */
+#define LEVEL_PACK_FILE "levels/default.pack"
+
+/* Shield properties: each shield is a SHIELD_WIDTH x SHIELD_HEIGHT cell
+ * bitmap (at most 8 x 8), every cell taking SHIELD_HEALTH hits */
+#define SHIELD_COUNT 4  /* Default shield count */
+#define SHIELD_WIDTH 6
+#define SHIELD_HEIGHT 2
 #define SHIELD_HEALTH 3
+#define SHIELD_COLUMN_BITS 8  /* Bits per column in a shield mask */
 
 /* Game state */
 #define INITIAL_LIVES 3
 #define INITIAL_LEVEL 1
 #define POINTS_PER_ENEMY 10
 #define POINTS_LEVEL_BONUS 100
+#define MAX_LEVEL 10  /* Clearing this level wins the game */
+#define GAME_EVENT_CAPACITY 128  /* Newest game events kept per GameState (power of two) */
+#define GAME_ARENA_HEADROOM 4096 /* Session arena bytes beyond the state: controller, per-game data */
+
+/* Game loop timing: one input poll and simulated tick per deadline, exact
+ * to the nanosecond (60 Hz is 16666666.67 ns, not 16 ms) */
+#define TARGET_FPS 60              /* Default tick rate (--tick-rate) */
+#define GAME_TICK_RATE_MAX 1000    /* Largest --tick-rate */
+#define GAME_MAX_CATCHUP_TICKS 4   /* Ticks run back to back after a stall; older ones are dropped */
+
+/* Turbo mode (--speed): frames simulated per rendered frame */
+#define GAME_SPEED_MAX 0          /* Unthrottled: simulate until the next render is due */
+#define GAME_SPEED_MAX_CHUNK 256  /* Frames between clock checks when unthrottled */
+#define GAME_SPEED_LIMIT 1000     /* Largest fixed multiplier */
+
+/* Event log written by interactive sessions */
+#define LOG_FILE "game_debug.log"
 
-/* Game loop timing */
-#define TARGET_FPS 60
-#define FRAME_TIME_MS (1000 / TARGET_FPS)
+/* Replay recording */
+#define REPLAY_KEYFRAME_INTERVAL 600  /* Frames between state-hash keyframes */
 
 /* Terminal minimum size for ncurses */
 #define MIN_TERM_WIDTH 100
@@ -63,6 +90,8 @@
 #define CHAR_PROJECTILE '|'
 #define CHAR_ENEMY_PROJECTILE 'v'
 #define CHAR_SHIELD '#'
+#define CHAR_SHIELD_DAMAGED '+'    /* Cell with fewer than SHIELD_HEALTH hits left */
+#define CHAR_SHIELD_CRUMBLING '.'  /* Cell with one hit left */
 #define CHAR_EMPTY ' '
 #define CHAR_WALL '='
 
@@ -20,33 +20,71 @@ typedef enum {
     CMD_SWITCH_VIEW  /* Not used in runtime, only at startup */
 } Command;
 
+/* Action bits: the commands of one tick or frame, applied together */
+typedef enum {
+    ACTION_LEFT = 1 << 0,
+    ACTION_RIGHT = 1 << 1,
+    ACTION_SHOOT = 1 << 2,
+    ACTION_PAUSE = 1 << 3,
+    ACTION_QUIT = 1 << 4  /* handled by the loop, never reaches the model */
+} ActionBit;
+
+/* Set of ActionBit values */
+typedef unsigned int ActionSet;
+
+/* Actions the model acts on (what a replay frame stores) */
+#define ACTION_GAME_MASK (ACTION_LEFT | ACTION_RIGHT | ACTION_SHOOT | ACTION_PAUSE)
+
+/* Input drained from a view in one tick */
+typedef struct {
+    ActionSet pressed;  /* key presses since the last poll, each acted on once */
+    ActionSet held;     /* movement keys down at poll time (views that can tell) */
+} TickInput;
+
 /* Controller structure */
 typedef struct {
     GameState *game_state;
     bool running;
+    int move_timer;  /* frames until a held direction steps again */
 } Controller;
 
 /**
- * Initialize controller with game state
+ * Initialize controller with game state; the controller is allocated from
+ * the game's session arena
+ * Returns NULL on error
  */
 Controller* controller_init(GameState *state);
 
 /**
- * Free controller resources
+ * Free controller resources (its memory goes with game_free)
  */
 void controller_free(Controller *ctrl);
 
 /**
- * Process a command (abstract input)
- * Returns true if command was processed, false otherwise
+ * Actions for the next simulated frame of a tick: `pressed` once (pass 0
+ * after the tick's first frame), plus a step every PLAYER_MOVE_PERIOD frames
+ * in a direction that stays `held`
  */
-bool controller_execute_command(Controller *ctrl, Command cmd);
+ActionSet controller_frame_actions(Controller *ctrl, ActionSet pressed, ActionSet held);
+
+/**
+ * Apply a set of actions: pause, then movement, then the shot
+ * Returns true if any action was processed
+ */
+bool controller_execute_actions(Controller *ctrl, ActionSet actions);
 
 /**
  * Update controller state for one frame
  */
 void controller_update(Controller *ctrl);
 
+/**
+ * Step n independent games by one frame each (no view involved)
+ * actions[i] is applied to states[i] before its update; actions may be NULL
+ * ACTION_QUIT has no effect here, callers decide when a batch stops
+ */
+void controller_update_batch(GameState *const *states, const ActionSet *actions, int n);
+
 /**
  * Check if controller should continue running
  */
@@ -0,0 +1,112 @@
+/*
+ * Space Invaders - Level Pack Header
+ * Versioned binary level layouts, memory-mapped and validated once at load
+ */
+
+#ifndef LEVELS_H
+#define LEVELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * File layout (little-endian, every field naturally aligned):
+ *   LevelPackHeader
+ *   level_count records of record_size bytes, each:
+ *     LevelRecord
+ *     u64 enemy mask[(enemy_count + 63) / 64]  bit i set: formation slot i
+ *                                              starts alive (slot = row * cols + col)
+ *     LevelShield shields[shield_count]
+ * The checksum is FNV-1a over the records. Records are read in place from
+ * the mapping, so a level change is a copy with no parsing; a byte-swapped
+ * version field makes big-endian hosts reject the pack at load.
+ * Build packs from text with tools/levelpack (make levels).
+ */
+#define LEVEL_PACK_MAGIC "SILV"
+#define LEVEL_PACK_VERSION 1
+
+/* Pack header (32 bytes): the board and formation every level is laid out for */
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t level_count;
+    uint16_t board_width, board_height;
+    uint32_t enemy_count;  /* formation slots */
+    uint16_t enemy_cols;   /* slots per formation row */
+    uint16_t enemy_spacing_x, enemy_spacing_y;
+    uint16_t shield_count;
+    uint32_t record_size;
+    uint32_t checksum;
+} LevelPackHeader;
+
+/* Per-level parameters (16 bytes) */
+typedef struct {
+    int16_t origin_x, origin_y;  /* formation origin at level start */
+    uint16_t move_period;        /* frames between formation steps at full strength */
+    uint16_t fire_period;        /* frames between enemy shots */
+    uint16_t shot_speed;         /* enemy projectile cells per frame */
+    uint16_t aim_chance;         /* percent of shots fired from the column over the player */
+    uint32_t alive;              /* set bits in the enemy mask */
+} LevelRecord;
+
+/* One shield (16 bytes); mask uses the Shield cell layout of model.h */
+typedef struct {
+    int16_t x, y;
+    uint32_t reserved;
+    uint64_t mask;
+} LevelShield;
+
+/* A mapped, validated pack */
+typedef struct {
+    const unsigned char *map;
+    size_t map_size;
+    const LevelPackHeader *header;
+    int enemy_words;  /* u64 words per enemy mask */
+} LevelPack;
+
+/**
+ * Map a pack file and validate every record against its header
+ * Returns NULL on error (message on stderr)
+ */
+LevelPack* level_pack_open(const char *path);
+
+/**
+ * Unmap a pack
+ */
+void level_pack_close(LevelPack *pack);
+
+/**
+ * Record size for a formation of `enemy_count` slots and `shield_count` shields
+ */
+size_t level_pack_record_size(int enemy_count, int shield_count);
+
+/**
+ * FNV-1a over `size` bytes, as stored in the header checksum
+ */
+uint32_t level_pack_checksum(const void *data, size_t size);
+
+/**
+ * Record for level `level` (1-based); levels past the end of the pack
+ * repeat its last level
+ */
+static inline const LevelRecord* level_pack_level(const LevelPack *pack, int level) {
+    int index = level < 1 ? 0 : level > pack->header->level_count ? pack->header->level_count - 1 : level - 1;
+    return (const LevelRecord *)(pack->map + sizeof(LevelPackHeader) +
+                                 (size_t)index * pack->header->record_size);
+}
+
+/**
+ * Enemy mask of a record
+ */
+static inline const uint64_t* level_pack_enemies(const LevelRecord *record) {
+    return (const uint64_t *)(record + 1);
+}
+
+/**
+ * Shields of a record
+ */
+static inline const LevelShield* level_pack_shields(const LevelPack *pack, const LevelRecord *record) {
+    return (const LevelShield *)(level_pack_enemies(record) + pack->enemy_words);
+}
+
+#endif /* LEVELS_H */
@@ -0,0 +1,81 @@
+/*
+ * Space Invaders - Event Log Header
+ * Low-overhead binary event log: producers append fixed-size records to a
+ * per-thread single-producer/single-consumer ring, a background thread
+ * formats them into the log file
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Log levels; LOG_LEVEL selects what is compiled in (make LOG_LEVEL=N) */
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_DEBUG 2
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/* Event kinds; the drain thread owns the text for each */
+typedef enum {
+    LOG_EV_PLAYER_SHOOT,  /* x, y */
+    LOG_EV_ENEMY_SHOOT,   /* x, y, enemy x, enemy y */
+    LOG_EV_ENEMY_KILLED,  /* projectile x, y, enemy x, enemy y */
+    LOG_EV_PLAYER_HIT,    /* projectile x, y, player x, y, health before, after */
+    LOG_EV_COUNT
+} LogEvent;
+
+/* One fixed-size record (32 bytes) */
+typedef struct {
+    uint32_t event;
+    int32_t frame;
+    int32_t args[6];
+} LogRecord;
+
+/* Records per thread ring (power of two); a full ring drops new records */
+#define LOG_RING_SIZE 4096
+/* Producer threads that can own a ring */
+#define LOG_MAX_THREADS 64
+
+/**
+ * Open the log file and start the drain thread
+ * Until this is called (and after log_shutdown) events cost one load and
+ * are discarded
+ * Returns false on error
+ */
+bool log_init(const char *path);
+
+/**
+ * Drain every ring, stop the drain thread and close the file
+ */
+void log_shutdown(void);
+
+/**
+ * Append an event to the calling thread's ring (never blocks)
+ * Use the LOG_INFO / LOG_DEBUG macros so the call compiles away below the
+ * build's LOG_LEVEL
+ */
+void log_event(LogEvent event, int frame, int a, int b, int c, int d, int e, int f);
+
+/**
+ * Records written since log_init and records dropped on full rings so far
+ */
+void log_stats(uint64_t *written, uint64_t *dropped);
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(event, frame, a, b, c, d, e, f) log_event(event, frame, a, b, c, d, e, f)
+#else
+#define LOG_INFO(event, frame, a, b, c, d, e, f) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(event, frame, a, b, c, d, e, f) log_event(event, frame, a, b, c, d, e, f)
+#else
+#define LOG_DEBUG(event, frame, a, b, c, d, e, f) ((void)0)
+#endif
+
+#endif /* LOG_H */
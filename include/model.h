@@ -6,34 +6,31 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include "config.h"
+#include "utils.h"
+#include "arena.h"
+#include "levels.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 /* Projectile structure */
 typedef struct {
     int x, y;
-    bool active;
 } Projectile;
 
-/* Shield block structure */
+/* Destructible shield: a cell bitmap anchored at (x, y). Masks are
+ * column-major with SHIELD_COLUMN_BITS bits per column, so bit c * 8 + r is
+ * cell (x + c, y + r) and one column is one byte. Health is stored as
+ * thermometer planes: health[k] has a cell's bit set while it can take more
+ * than k hits, so health[0] is the live mask and erosion is a few word-wide
+ * AND/OR operations. */
 typedef struct {
     int x, y;
-    int health;  /* 0 = destroyed */
-} ShieldBlock;
-
-/* Shield structure */
-typedef struct {
-    ShieldBlock blocks[8 * 6];
-    int block_count;
+    uint64_t health[SHIELD_HEALTH];
 } Shield;
 
-/* Enemy structure */
-typedef struct {
-    int x, y;
-    bool active;
-    int health;  /* 1 for basic enemies */
-} Enemy;
-
 /* Player structure */
 typedef struct {
     int x, y;
@@ -41,20 +38,117 @@ typedef struct {
     int score;
 } Player;
 
-/* Game state structure */
+/* Enemy formation: slots sit on a rows x cols grid (slot = row * cols + col)
+ * with a fixed pitch from a moving origin. Per-column/row alive counts keep the
+ * extents of the live formation current, so movement checks are constant-time.
+ * The shooter index (col_bottom plus the live column list) is kept current on
+ * every kill, so picking the enemy that fires is constant-time too. */
+typedef struct {
+    int origin_x, origin_y;
+    int rows, cols;
+    int spacing_x, spacing_y;  /* slot pitch: column c is spacing_x * c from the origin */
+    int *col_alive;            /* cols entries: live enemies per column */
+    int *row_alive;            /* rows entries: live enemies per row */
+    int left_col, right_col, bottom_row;  /* extreme live column/row, -1 when empty */
+    int *col_bottom;           /* cols entries: lowest live row of each column, -1 when empty */
+    int *live_cols;            /* columns with a live enemy, [0, live_col_count), unordered */
+    int *live_col_pos;         /* cols entries: index of the column in live_cols */
+    int live_col_count;
+} Formation;
+
+/* One bitboard layer: `width` columns of `words` 64-bit words, column-major,
+ * so bit y % 64 of word y / 64 of a column is row y. A vertical path is a
+ * masked bit scan per 64 rows it crosses. */
+typedef struct {
+    uint64_t *cols;  /* width * words words */
+    int width, height;
+    int words;       /* words per column: (height + 63) / 64 */
+} GridLayer;
+
+/* Collision broadphase. The enemy layer is in formation-local coordinates
+ * and spans the formation, so it only changes when an enemy dies, and the
+ * owner of a covered cell follows from the slot pitch. The shield layer is
+ * the union of the shield live masks in board coordinates. */
+typedef struct {
+    GridLayer enemy;
+    GridLayer shield;
+} CollisionGrid;
+
+/* Things that happened in the simulation, for views, audio and stats */
+typedef enum {
+    GAME_EV_PLAYER_SHOT,    /* x, y: new projectile */
+    GAME_EV_ENEMY_SHOT,     /* x, y: new projectile; value: enemy slot */
+    GAME_EV_ENEMY_KILLED,   /* x, y: enemy position; value: enemy slot */
+    GAME_EV_SHIELD_HIT,     /* x, y: block position; value: block health left */
+    GAME_EV_PLAYER_HIT,     /* x, y: impact; value: lives left */
+    GAME_EV_LEVEL_CHANGED,  /* value: new level */
+    GAME_EV_GAME_OVER,      /* value: 1 if the player won */
+    GAME_EV_COUNT
+} GameEventType;
+
+/* One event (16 bytes) */
+typedef struct {
+    uint8_t type;    /* GameEventType */
+    int16_t x, y;
+    int32_t value;   /* wide enough for any enemy slot */
+    int32_t frame;   /* frame_count when it happened */
+} GameEvent;
+
+/* Event ring: the newest GAME_EVENT_CAPACITY events. The model appends;
+ * each consumer keeps its own cursor (game_event_next), so reading never
+ * allocates or disturbs other consumers. */
+typedef struct {
+    GameEvent events[GAME_EVENT_CAPACITY];
+    uint32_t head;          /* events appended so far */
+} GameEventRing;
+
+/* Board size and entity capacities of a game, fixed for its lifetime.
+ * game_config_default gives the classic board from config.h. */
 typedef struct {
+    int board_width, board_height;
+    int enemy_count;                  /* formation slots */
+    int enemy_cols;                   /* slots per formation row */
+    int enemy_spacing_x, enemy_spacing_y;
+    int max_projectiles;
+    int max_enemy_projectiles;
+    int shield_count;
+} GameConfig;
+
+/* Game state structure. A state is one block at the start of its session
+ * arena: this header followed by the arrays its pointers refer to, laid out
+ * for `config`. Copy states with game_copy, never by assignment. */
+typedef struct {
+    Arena *arena;  /* session arena: this block, the controller, per-game data */
+    GameConfig config;
+    size_t size;   /* bytes in the block, header included */
+    
     Player player;
-    Enemy enemies[55];  /* MAX_ENEMIES */
-    int enemy_count;
-    int alive_enemy_count;
     
-    Projectile projectiles[100];  /* MAX_PROJECTILES */
+    /* Enemies: slot i is alive when bit i % 64 of enemy_alive[i / 64] is set */
+    Formation formation;
+    uint64_t *enemy_alive;  /* enemy_words words */
+    int enemy_words;
+    int enemy_count;  /* slots in use */
+    int alive_count;
+    
+    /* Dense pools: the live projectiles are exactly [0, count) */
+    Projectile *projectiles;  /* config.max_projectiles */
     int projectile_count;
     
-    Projectile enemy_projectiles[30];  /* MAX_ENEMY_PROJECTILES */
+    Projectile *enemy_projectiles;  /* config.max_enemy_projectiles */
     int enemy_projectile_count;
     
-    Shield shields[4];  /* SHIELD_COUNT */
+    int projectile_speed;        /* cells per frame, PROJECTILE_SPEED by default */
+    int enemy_projectile_speed;  /* cells per frame, set by the level */
+    int enemy_move_period;       /* frames between formation steps at full strength */
+    int enemy_fire_period;       /* frames between enemy shots */
+    int enemy_aim_chance;        /* percent of enemy shots fired from the player's column */
+    
+    const LevelPack *levels;     /* level layouts, NULL for the built-in one */
+    
+    Shield *shields;  /* config.shield_count */
+    
+    CollisionGrid grid;
     
     int level;
     int frame_count;
@@ -67,32 +161,172 @@ typedef struct {
     int enemy_direction;  /* 1 = right, -1 = left */
     int enemy_move_counter;
     
+    Rng rng;  /* per-game generator: games never share random state */
+    
+    GameEventRing events;
+    
 } GameState;
 
+/**
+ * Board position of enemy slot i (formation origin plus the slot's offsets)
+ */
+static inline int game_enemy_x(const GameState *state, int i) {
+    return state->formation.origin_x + (i % state->formation.cols) * state->formation.spacing_x;
+}
+
+static inline int game_enemy_y(const GameState *state, int i) {
+    return state->formation.origin_y + (i / state->formation.cols) * state->formation.spacing_y;
+}
+
+/**
+ * Enemy that fires from formation column `col`: its lowest live enemy,
+ * -1 when the column is empty
+ */
+static inline int game_column_shooter(const GameState *state, int col) {
+    int row = state->formation.col_bottom[col];
+    return row < 0 ? -1 : row * state->formation.cols + col;
+}
+
+/**
+ * Whether enemy slot i is alive
+ */
+static inline bool game_enemy_alive(const GameState *state, int i) {
+    return (state->enemy_alive[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * First live enemy slot at or after `from`, -1 when there is none
+ */
+static inline int game_next_enemy(const GameState *state, int from) {
+    for (int w = from / 64; w < state->enemy_words; w++) {
+        uint64_t m = state->enemy_alive[w];
+        if (w == from / 64) m &= ~0ULL << (from % 64);
+        if (m) return w * 64 + utils_ctz64(m);
+    }
+    return -1;
+}
+
+/**
+ * Hits left in the shield cell at mask bit `bit` (0 when destroyed)
+ */
+static inline int game_shield_cell_health(const Shield *shield, int bit) {
+    int health = 0;
+    for (int k = 0; k < SHIELD_HEALTH; k++) {
+        health += (int)((shield->health[k] >> bit) & 1);
+    }
+    return health;
+}
+
+/**
+ * Take a slot from a dense projectile pool, NULL when it is full
+ */
+static inline Projectile *game_projectile_alloc(Projectile *pool, int *count, int capacity) {
+    return *count < capacity ? &pool[(*count)++] : NULL;
+}
+
+/**
+ * Release slot i of a dense projectile pool: the last live projectile moves
+ * into the hole, so order is not preserved. Callers iterating the pool
+ * revisit slot i afterwards.
+ */
+static inline void game_projectile_release(Projectile *pool, int *count, int i) {
+    pool[i] = pool[--(*count)];
+}
+
+/* Fixed-capacity ring of recent game states (rollback, lookahead, frame
+ * stepping). Storage is allocated once for states of one configuration;
+ * snapshot/restore are plain block copies. */
+typedef struct {
+    unsigned char *frames;  /* capacity slots of frame_size bytes */
+    size_t frame_size;
+    int capacity;
+    int head;           /* slot of the next snapshot */
+    int count;          /* valid snapshots, at most capacity */
+} SnapshotRing;
+
 /* Function prototypes */
 
 /**
- * Initialize game state
+ * Initialize game state with a fresh entropy seed
  * Returns newly allocated GameState, or NULL on error
  */
 GameState* game_init(void);
 
 /**
- * Set the game to a specific level (reinitialize enemies/shields)
- * level is 1-based
+ * Initialize game state with a fixed seed; the same seed and the same
+ * inputs always produce the same game
+ * Returns newly allocated GameState, or NULL on error
+ */
+GameState* game_init_seeded(uint64_t seed);
+
+/**
+ * Fill in the classic board and capacities from config.h
+ */
+void game_config_default(GameConfig *config);
+
+/**
+ * Fill in the default capacities with the board and formation a level pack
+ * is laid out for
+ */
+void game_config_level_pack(GameConfig *config, const LevelPack *pack);
+
+/**
+ * Initialize a game with a runtime board size and entity capacities. The
+ * game gets a session arena (one heap allocation) holding the state and its
+ * arrays, with GAME_ARENA_HEADROOM bytes left for the controller and
+ * per-game data
+ * Returns newly allocated GameState, or NULL if the config is invalid (the
+ * formation must fit the board) or on allocation failure
+ */
+GameState* game_init_ex(const GameConfig *config, uint64_t seed);
+
+/**
+ * Initialize a game laid out for a level pack (NULL: the built-in levels),
+ * with the default capacities, playing the pack's levels from the start.
+ * The formation only has to fit each level at its own origin, as
+ * level_pack_open checked; the pack must outlive the game.
+ * Returns newly allocated GameState, or NULL on allocation failure
+ */
+GameState* game_init_level_pack(const LevelPack *pack, uint64_t seed);
+
+/**
+ * Copy src into dst; both must have been created with the same config
+ * Returns false if their layouts differ
+ */
+bool game_copy(GameState *dst, const GameState *src);
+
+/**
+ * Take level layouts from a pack (NULL: the built-in layout) and lay out the
+ * current level again. Level changes then copy records out of the pack; the
+ * pack must outlive the game.
+ * Returns false if the game's config does not match the pack's board and
+ * formation (see game_config_level_pack), or, for the built-in layout, if
+ * the formation does not fit at ENEMY_START_X/Y
+ */
+bool game_use_level_pack(GameState *state, const LevelPack *pack);
+
+/**
+ * Seek the game to a specific level (1-based) in constant time: enemies and
+ * shields are built once and the score is set to the skipped level bonuses
  */
 void game_set_level(GameState *state, int level);
 
 /**
- * Free game state and all resources
+ * Free game state and its session arena (and so its controller)
  */
 void game_free(GameState *state);
 
 /**
- * Reset game to initial state
+ * Reset game to initial state (the random stream continues); releases the
+ * per-game part of the session arena
  */
 void game_reset(GameState *state);
 
+/**
+ * Reseed the game's generator and reset it
+ */
+void game_reset_seeded(GameState *state, uint64_t seed);
+
 /**
  * Update game logic for one frame
  */
@@ -118,6 +352,46 @@ void game_player_shoot(GameState *state);
  */
 void game_toggle_pause(GameState *state);
 
+/**
+ * Move every projectile of a dense pool `dy` cells and release the ones whose
+ * swept path this frame lies entirely off a board of `height` rows
+ * Returns the new live count; cost is proportional to `count` only
+ */
+int game_advance_projectiles(Projectile *pool, int count, int dy, int height);
+
+/**
+ * Cursor positioned after the newest event, for a consumer that only wants
+ * what happens from now on (a zeroed cursor starts at the oldest kept event)
+ */
+uint32_t game_event_cursor(const GameState *state);
+
+/**
+ * Next event after *cursor, advancing it; NULL once caught up
+ * A consumer that fell more than GAME_EVENT_CAPACITY events behind skips to
+ * the oldest kept one; after a rollback (game_restore) it resynchronizes
+ */
+const GameEvent* game_event_next(const GameState *state, uint32_t *cursor);
+
+/**
+ * Number of enemies still alive
+ */
+int game_alive_enemy_count(const GameState *state);
+
+/**
+ * 64-bit hash of the simulation-relevant state (FNV-1a over explicit fields,
+ * so struct padding and derived caches never matter). Equal states hash equal
+ * across runs and builds; used to detect replay divergence.
+ */
+uint64_t game_hash(const GameState *state);
+
+/**
+ * Closed-form formation position `frames` frames from now, assuming no enemy
+ * dies in between. Stops where the formation would reach the bottom.
+ * Any output pointer may be NULL.
+ */
+void game_formation_at(const GameState *state, int frames,
+                       int *origin_x, int *origin_y, int *direction);
+
 /**
  * Check if game is over
  */
@@ -128,6 +402,30 @@ bool game_is_over(GameState *state);
  */
 bool game_is_won(GameState *state);
 
+/**
+ * Create a snapshot ring holding the last `capacity` frames of games laid
+ * out like `state`
+ * Returns NULL on error
+ */
+SnapshotRing* game_snapshot_ring_create(const GameState *state, int capacity);
+
+/**
+ * Free a snapshot ring
+ */
+void game_snapshot_ring_free(SnapshotRing *ring);
+
+/**
+ * Record the current state, overwriting the oldest snapshot when full
+ */
+void game_snapshot(SnapshotRing *ring, const GameState *state);
+
+/**
+ * Restore the snapshot taken `frames_back` snapshots ago (0 = most recent)
+ * and drop every newer snapshot, so recording resumes from that frame
+ * Returns false if the ring does not reach that far back
+ */
+bool game_restore(SnapshotRing *ring, GameState *state, int frames_back);
+
 /**
  * Load high scores from file
  */
@@ -0,0 +1,112 @@
+/*
+ * Space Invaders - Frame Profiler Header
+ * Per-phase latency histograms for the interactive loop, an on-screen
+ * overlay and an exit summary
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "utils.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Phases of one loop iteration */
+typedef enum {
+    PROFILE_INPUT,    /* view_interface.handle_input */
+    PROFILE_SIM,      /* the frames simulated for one poll */
+    PROFILE_RENDER,   /* drawing into the view's back buffer */
+    PROFILE_PRESENT,  /* terminal flush / SDL_RenderPresent */
+    PROFILE_FRAME,    /* the whole iteration, sleep excluded */
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+/* Log-bucketed histogram: values below 8 ns get a bucket each, every power
+ * of two above is split into 8 sub-buckets, so a bucket is at most 12.5%
+ * wide and a record is a count-leading-zeros and an increment */
+#define PROFILE_SUB_BITS 3
+#define PROFILE_SUB_BUCKETS (1 << PROFILE_SUB_BITS)
+#define PROFILE_BUCKETS ((64 - PROFILE_SUB_BITS + 1) * PROFILE_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t buckets[PROFILE_BUCKETS];
+} Histogram;
+
+/* Samples per overlay refresh; the overlay shows the last window only */
+#define PROFILE_OVERLAY_WINDOW 120
+
+/* Overlay text: one line per phase */
+#define PROFILE_OVERLAY_WIDTH 64
+
+/* Recording switch, checked inline so a disabled profiler costs a branch */
+extern bool profile_active;
+
+/**
+ * Turn recording (and the overlay) on for the rest of the process
+ */
+void profile_enable(void);
+
+/**
+ * Show or hide the overlay (views bind this to the F key)
+ */
+void profile_toggle_overlay(void);
+
+/**
+ * True if the views should draw the overlay
+ */
+bool profile_overlay_visible(void);
+
+/**
+ * Overlay line for `phase` as of the last completed window
+ */
+const char* profile_overlay_line(ProfilePhase phase);
+
+/**
+ * Add one sample to a phase
+ */
+void profile_record(ProfilePhase phase, uint64_t ns);
+
+/**
+ * Close one loop iteration; refreshes the overlay once per window
+ */
+void profile_frame_end(void);
+
+/**
+ * Value at quantile `q` (0..1) of a histogram, as the upper edge of its
+ * bucket capped at the largest sample
+ */
+uint64_t profile_quantile(const Histogram *hist, double q);
+
+/**
+ * Histogram of `phase` since profile_enable
+ */
+const Histogram* profile_histogram(ProfilePhase phase);
+
+/**
+ * Print count, mean, p50/p99/p999 and max of every phase
+ */
+void profile_summary(FILE *out);
+
+/**
+ * Timestamp for a phase boundary, 0 while profiling is off
+ */
+static inline uint64_t profile_clock(void) {
+    return profile_active ? utils_time_ns() : 0;
+}
+
+/**
+ * Record the time from `start` (a profile_clock value) to now under
+ * `phase` and return now, so consecutive phases share one clock read
+ */
+static inline uint64_t profile_lap(ProfilePhase phase, uint64_t start) {
+    if (!profile_active) return 0;
+    uint64_t now = utils_time_ns();
+    profile_record(phase, now - start);
+    return now;
+}
+
+#endif /* PROFILE_H */
@@ -0,0 +1,135 @@
+/*
+ * Space Invaders - Replay Header
+ * Compact recording of a session's seed and per-frame action stream
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "model.h"
+#include "controller.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * File layout (all integers are LEB128 varints unless noted):
+ *   "SIRP" magic, u8 version, seed, start_level, keyframe_interval,
+ *   level pack checksum (0: built-in levels)
+ *   records: varint (run << REPLAY_TAG_BITS) | tag
+ *     run  = idle frames (no action) preceding the record
+ *     tag  = 1..15: one frame with that ActionSet (ACTION_GAME_MASK bits;
+ *                   ACTION_QUIT never reaches the model and is not stored)
+ *            REPLAY_TAG_KEYFRAME: frame number varint + u64 state hash (LE),
+ *                                 taken after that many frames were simulated
+ *            REPLAY_TAG_END:      end of stream
+ * Idle frames cost nothing until the next record, so a mostly idle session
+ * stays at a few bytes per second.
+ *
+ * Version 5 keeps the version 4 layout. It marks recordings made under the
+ * current enemy fire rules (every fire period shoots, from the bottom enemy
+ * of a live column). Older files re-simulate into different games, so the
+ * reader rejects them with a version error instead of a hash mismatch.
+ *
+ * Version 6 keeps the same layout again. A game on a level pack now starts
+ * with the pack's first level instead of a throwaway built-in layout, whose
+ * random shield positions used to advance the generator, so version 5
+ * files recorded on a pack are rejected. Version 5 files on the built-in
+ * levels (pack checksum 0) still replay.
+ *
+ * Keyframes are divergence checkpoints, not seek points: they hold no state
+ * and there is no offset index, so reaching frame N means re-simulating from
+ * frame 0. That is deliberate. Restartable snapshots would be raw state
+ * blocks of a few KiB each, a hundred times the size of the action stream,
+ * and a verifier cannot trust a state it did not simulate. Re-simulation
+ * runs at roughly 75 ns per frame, so an hour of play at 60 Hz replays in
+ * about 20 ms.
+ */
+#define REPLAY_MAGIC "SIRP"
+#define REPLAY_VERSION 6
+#define REPLAY_MIN_VERSION 5  /* oldest version the reader accepts */
+#define REPLAY_PACK_MIN_VERSION 6  /* oldest version it accepts on a level pack */
+#define REPLAY_TAG_BITS 5
+#define REPLAY_TAG_KEYFRAME 0
+#define REPLAY_TAG_END 16
+
+/* Replay writer */
+typedef struct {
+    FILE *fp;
+    uint64_t frame;         /* frames recorded so far */
+    uint64_t pending_none;  /* idle frames not yet written */
+    int keyframe_interval;
+} ReplayWriter;
+
+/* Kind of step produced by the reader */
+typedef enum {
+    REPLAY_STEP_FRAME,     /* simulate one frame with `actions` */
+    REPLAY_STEP_KEYFRAME,  /* state after `frame` frames must hash to `hash` */
+    REPLAY_STEP_END,
+    REPLAY_STEP_ERROR
+} ReplayStepType;
+
+/* One decoded step */
+typedef struct {
+    ReplayStepType type;
+    ActionSet actions;
+    uint64_t frame;
+    uint64_t hash;
+} ReplayStep;
+
+/* Replay reader (whole file held in memory) */
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint64_t seed;
+    int start_level;  /* level the game was seeked to (game_set_level) */
+    uint32_t levels_checksum;  /* level pack the game used, 0 for built-in levels */
+    int keyframe_interval;
+    int version;
+    uint64_t pending_none;
+    ReplayStep pending;  /* record decoded after its idle run */
+    bool has_pending;
+} ReplayReader;
+
+/**
+ * Create a replay file and write its header; `levels_checksum` identifies
+ * the level pack in use (0 for the built-in levels)
+ * Returns NULL on error
+ */
+ReplayWriter* replay_writer_open(const char *path, uint64_t seed, int start_level,
+                                 uint32_t levels_checksum);
+
+/**
+ * Record one simulated frame: the actions applied before the update and the
+ * state after it (hashed into a keyframe every keyframe_interval frames)
+ */
+void replay_writer_frame(ReplayWriter *writer, ActionSet actions, const GameState *state);
+
+/**
+ * Record a keyframe for the current state without advancing the frame count
+ */
+void replay_writer_keyframe(ReplayWriter *writer, const GameState *state);
+
+/**
+ * Write the end marker and close the file
+ */
+void replay_writer_close(ReplayWriter *writer);
+
+/**
+ * Load a replay file and parse its header
+ * Returns NULL on error (message on stderr)
+ */
+ReplayReader* replay_reader_open(const char *path);
+
+/**
+ * Decode the next step of the stream
+ */
+ReplayStep replay_reader_next(ReplayReader *reader);
+
+/**
+ * Free a reader
+ */
+void replay_reader_close(ReplayReader *reader);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,63 @@
+/*
+ * Space Invaders - Scene Header
+ * View-agnostic draw list: the board as rectangles of board cells, built
+ * once per frame from a GameState and grouped by material for every view
+ */
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "model.h"
+
+/* What a rectangle is drawn as; each view maps materials to its own
+ * glyphs and colors. Groups appear in the list in this order. */
+typedef enum {
+    MATERIAL_PLAYER,
+    MATERIAL_ENEMY,
+    MATERIAL_PROJECTILE,
+    MATERIAL_ENEMY_PROJECTILE,
+    MATERIAL_SHIELD,             /* shield cell at full health */
+    MATERIAL_SHIELD_DAMAGED,     /* fewer than SHIELD_HEALTH hits left */
+    MATERIAL_SHIELD_CRUMBLING,   /* one hit left */
+    MATERIAL_COUNT
+} Material;
+
+/* Rectangle in board cells, clipped to the board */
+typedef struct {
+    int x, y, w, h;
+} SceneRect;
+
+/* Draw list: the rectangles of material m are
+ * rects[group[m]] .. rects[group[m + 1] - 1] */
+typedef struct {
+    SceneRect *rects;
+    int capacity;
+    int group[MATERIAL_COUNT + 1];
+} Scene;
+
+/**
+ * Create a scene large enough for every entity a game of `config` can hold
+ * Returns NULL on error
+ */
+Scene* scene_create(const GameConfig *config);
+
+/**
+ * Free a scene
+ */
+void scene_free(Scene *scene);
+
+/**
+ * Rebuild the draw list from `state`; rectangles off the board are dropped
+ * and the rest clipped to it. Never allocates.
+ */
+void scene_build(Scene *scene, const GameState *state);
+
+/**
+ * First rectangle of a material and their number
+ */
+static inline const SceneRect* scene_group(const Scene *scene, Material material, int *count) {
+    *count = scene->group[material + 1] - scene->group[material];
+    return scene->rects + scene->group[material];
+}
+
+#endif /* SCENE_H */
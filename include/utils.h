@@ -7,6 +7,7 @@
 #define UTILS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * Rectangle collision detection
@@ -19,10 +20,25 @@ bool utils_rect_collision(int x1, int y1, int w1, int h1,
  */
 int utils_clamp(int value, int min, int max);
 
+/* Per-instance pseudo random generator (xoshiro256**), no shared state */
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/**
+ * Seed a generator; any 64-bit seed (including 0) gives a valid stream
+ */
+void utils_rng_seed(Rng *rng, uint64_t seed);
+
+/**
+ * Next 64 random bits
+ */
+uint64_t utils_rng_next(Rng *rng);
+
 /**
  * Random integer between min and max (inclusive)
  */
-int utils_random_int(int min, int max);
+int utils_rng_int(Rng *rng, int min, int max);
 
 /**
  * Sleep for milliseconds
@@ -30,13 +46,62 @@ int utils_random_int(int min, int max);
 void utils_sleep_ms(int ms);
 
 /**
- * Get current time in milliseconds
+ * Get current time in milliseconds (monotonic)
  */
 unsigned long utils_time_ms(void);
 
 /**
- * Initialize random seed
+ * Monotonic clock in nanoseconds; never jumps with wall-clock changes
+ */
+uint64_t utils_time_ns(void);
+
+/**
+ * Sleep until the monotonic clock reaches `deadline_ns` (absolute, so a late
+ * wakeup never pushes back later deadlines); returns at once if it has passed
+ */
+void utils_sleep_until_ns(uint64_t deadline_ns);
+
+/* Fixed-timestep pacer: tick k is due at start_ns + k * 1e9 / rate, computed
+ * from the tick index so a non-integer tick length never drifts */
+typedef struct {
+    uint64_t start_ns;  /* when tick 0 was due */
+    uint64_t ticks;     /* ticks handed out (or dropped) so far */
+    int rate;           /* ticks per second */
+} Pacer;
+
+/**
+ * Start pacing `rate` ticks per second with tick 0 due at `now_ns`
+ */
+void utils_pacer_start(Pacer *pacer, int rate, uint64_t now_ns);
+
+/**
+ * Ticks due by `now_ns` and not handed out yet, at most `max_catchup`;
+ * after a longer stall the older ticks are dropped rather than run late
+ */
+int utils_pacer_due(Pacer *pacer, uint64_t now_ns, int max_catchup);
+
+/**
+ * When the next tick is due
+ */
+uint64_t utils_pacer_next(const Pacer *pacer);
+
+/**
+ * Fresh seed from the clock and process id, for non-reproducible runs
+ */
+uint64_t utils_entropy_seed(void);
+
+/**
+ * Number of set bits in a 64-bit mask
+ */
+static inline int utils_popcount64(uint64_t mask) {
+    return __builtin_popcountll(mask);
+}
+
+/**
+ * Index of the lowest set bit (mask must be non-zero)
  */
-void utils_random_seed(void);
+static inline int utils_ctz64(uint64_t mask) {
+    return __builtin_ctzll(mask);
+}
 
 #endif /* UTILS_H */
@@ -0,0 +1,65 @@
+/*
+ * Space Invaders - View (ANSI) Header
+ * Text-based rendering straight to the terminal, without curses
+ */
+
+#ifndef VIEW_ANSI_H
+#define VIEW_ANSI_H
+
+#include "model.h"
+#include "controller.h"
+#include "scene.h"
+#include <stdbool.h>
+
+/**
+ * Initialize ANSI view for the board of `config`: raw terminal mode and the
+ * alternate screen
+ * Returns true on success, false if stdin/stdout is not a large enough terminal
+ */
+bool view_ansi_init(const GameConfig *config);
+
+/**
+ * Cleanup ANSI view and restore the terminal
+ */
+void view_ansi_cleanup(void);
+
+/**
+ * Render game state: the HUD from `state`, the board from its scene
+ * Encodes the cells that changed since the last frame; view_ansi_present
+ * sends them
+ */
+void view_ansi_render(const GameState *state, const Scene *scene);
+
+/**
+ * Write the encoded frame to the terminal in one write()
+ */
+void view_ansi_present(void);
+
+/**
+ * Drain all pending input into one tick's actions
+ * Returns an empty set if no key was pressed
+ */
+TickInput view_ansi_handle_input(void);
+
+/**
+ * Display pause screen
+ */
+void view_ansi_show_pause(void);
+
+/**
+ * Display game over screen
+ */
+void view_ansi_show_game_over(const GameState *state);
+
+/**
+ * Display main menu
+ */
+Command view_ansi_show_menu(void);
+
+/**
+ * UI-level controls: set/get the currently selected start level in the menu UI
+ */
+void view_ansi_set_ui_level(int level);
+int view_ansi_get_ui_level(void);
+
+#endif /* VIEW_ANSI_H */
@@ -8,6 +8,7 @@
 
 #include "model.h"
 #include "controller.h"
+#include "scene.h"
 #include <stdbool.h>
 
 typedef struct {
@@ -16,10 +17,10 @@ typedef struct {
 } ViewDimensions;
 
 /**
- * Initialize ncurses view
+ * Initialize ncurses view, sized for the board of `config`
  * Returns true on success, false on error
  */
-bool view_ncurses_init(void);
+bool view_ncurses_init(const GameConfig *config);
 
 /**
  * Cleanup ncurses view
@@ -27,15 +28,22 @@ bool view_ncurses_init(void);
 void view_ncurses_cleanup(void);
 
 /**
- * Render game state to terminal
+ * Render game state to terminal: the HUD from `state`, the board from its
+ * scene
+ * Draws off-screen; view_ncurses_present shows the frame
  */
-void view_ncurses_render(const GameState *state);
+void view_ncurses_render(const GameState *state, const Scene *scene);
 
 /**
- * Handle input and return command
- * Returns CMD_NONE if no input or timeout
+ * Write the rendered frame to the terminal
  */
-Command view_ncurses_handle_input(void);
+void view_ncurses_present(void);
+
+/**
+ * Drain all pending input into one tick's actions
+ * Returns an empty set if no key was pressed
+ */
+TickInput view_ncurses_handle_input(void);
 
 /**
  * Get terminal dimensions
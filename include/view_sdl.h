@@ -8,13 +8,14 @@
 
 #include "model.h"
 #include "controller.h"
+#include "scene.h"
 #include <stdbool.h>
 
 /**
- * Initialize SDL3 view
+ * Initialize SDL3 view, a window sized for the board of `config`
  * Returns true on success, false on error
  */
-bool view_sdl_init(void);
+bool view_sdl_init(const GameConfig *config);
 
 /**
  * Cleanup SDL3 view
@@ -22,15 +23,28 @@ bool view_sdl_init(void);
 void view_sdl_cleanup(void);
 
 /**
- * Render game state to SDL window
+ * Render game state to SDL window: the board from the scene of `state`
+ * Draws into the back buffer; view_sdl_present shows the frame
  */
-void view_sdl_render(const GameState *state);
+void view_sdl_render(const GameState *state, const Scene *scene);
 
 /**
- * Handle input and return command
- * Returns CMD_NONE if no input or timeout
+ * Renderer calls (draw color changes included) made by the last
+ * view_sdl_render; entities of one material share a single fill call
  */
-Command view_sdl_handle_input(void);
+int view_sdl_draw_calls(void);
+
+/**
+ * Present the rendered frame
+ */
+void view_sdl_present(void);
+
+/**
+ * Drain all pending events into one tick's actions; held movement keys come
+ * from the keyboard state, not from key repeat
+ * Returns an empty set if nothing happened
+ */
+TickInput view_sdl_handle_input(void);
 
 /**
  * Display pause screen
@@ -0,0 +1,147 @@
+/*
+ * Space Invaders - C Allocator Call Counter
+ * LD_PRELOAD shim for --check-alloc: counts each allocation call and
+ * forwards it to the allocator behind it (RTLD_NEXT)
+ */
+
+#define _GNU_SOURCE
+
+#include "alloc_count.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t alloc_count_calls;
+
+/* The allocator this one forwards to */
+static void *(*next_malloc)(size_t size);
+static void *(*next_calloc)(size_t count, size_t size);
+static void *(*next_realloc)(void *block, size_t size);
+static void (*next_free)(void *block);
+static void *(*next_memalign)(size_t alignment, size_t size);
+static void *(*next_aligned_alloc)(size_t alignment, size_t size);
+static int (*next_posix_memalign)(void **block, size_t alignment, size_t size);
+
+/* Serves the allocations dlsym itself may make while the lookup runs; the
+ * blocks are never released */
+static unsigned char boot_buf[4096] __attribute__((aligned(64)));
+static size_t boot_used;
+static int resolving;
+
+void *memalign(size_t alignment, size_t size);
+
+/**
+ * Carve `size` bytes aligned to `alignment` out of the boot buffer
+ * Returns NULL once it is used up
+ */
+static void *boot_alloc(size_t alignment, size_t size) {
+    if (alignment < 16) alignment = 16;
+    size_t at = (boot_used + alignment - 1) & ~(alignment - 1);
+    if (at > sizeof(boot_buf) || size > sizeof(boot_buf) - at) return NULL;
+    boot_used = at + size;
+    return boot_buf + at;
+}
+
+/**
+ * Whether `block` came from the boot buffer
+ */
+static int is_boot(const void *block) {
+    const unsigned char *p = block;
+    return p >= boot_buf && p < boot_buf + sizeof(boot_buf);
+}
+
+/**
+ * Look the next allocator up. The first allocation runs on the main
+ * thread during startup, before any other thread exists.
+ */
+static void resolve(void) {
+    resolving = 1;
+    next_malloc = (void *(*)(size_t))dlsym(RTLD_NEXT, "malloc");
+    next_calloc = (void *(*)(size_t, size_t))dlsym(RTLD_NEXT, "calloc");
+    next_realloc = (void *(*)(void *, size_t))dlsym(RTLD_NEXT, "realloc");
+    next_free = (void (*)(void *))dlsym(RTLD_NEXT, "free");
+    next_memalign = (void *(*)(size_t, size_t))dlsym(RTLD_NEXT, "memalign");
+    next_aligned_alloc = (void *(*)(size_t, size_t))dlsym(RTLD_NEXT, "aligned_alloc");
+    next_posix_memalign = (int (*)(void **, size_t, size_t))dlsym(RTLD_NEXT, "posix_memalign");
+    resolving = 0;
+}
+
+/**
+ * Count one allocation call
+ */
+static void count_call(void) {
+    __atomic_fetch_add(&alloc_count_calls, 1, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+    if (!next_malloc) {
+        if (resolving) return boot_alloc(16, size);
+        resolve();
+    }
+    count_call();
+    return next_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (!next_calloc) {
+        /* The boot buffer is static, so already zeroed */
+        if (resolving) return size && count > (size_t)-1 / size ? NULL : boot_alloc(16, count * size);
+        resolve();
+    }
+    count_call();
+    return next_calloc(count, size);
+}
+
+void *realloc(void *block, size_t size) {
+    if (!next_realloc) {
+        if (resolving) return NULL;
+        resolve();
+    }
+    if (is_boot(block)) {
+        /* Move a boot block to the real heap */
+        void *moved = malloc(size);
+        size_t avail = (size_t)(boot_buf + sizeof(boot_buf) - (unsigned char *)block);
+        if (moved) memcpy(moved, block, size < avail ? size : avail);
+        return moved;
+    }
+    count_call();
+    return next_realloc(block, size);
+}
+
+void free(void *block) {
+    if (!block || is_boot(block)) return;
+    if (!next_free) resolve();
+    next_free(block);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    if (!next_memalign) {
+        if (resolving) return boot_alloc(alignment, size);
+        resolve();
+    }
+    count_call();
+    return next_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    if (!next_aligned_alloc) {
+        if (resolving) return boot_alloc(alignment, size);
+        resolve();
+    }
+    count_call();
+    return next_aligned_alloc(alignment, size);
+}
+
+int posix_memalign(void **block, size_t alignment, size_t size) {
+    if (!next_posix_memalign) {
+        if (resolving) {
+            *block = boot_alloc(alignment, size);
+            return *block ? 0 : ENOMEM;
+        }
+        resolve();
+    }
+    count_call();
+    return next_posix_memalign(block, alignment, size);
+}
@@ -0,0 +1,132 @@
+/*
+ * Space Invaders - Arena Allocator Implementation
+ * One heap block per arena, bump allocation, counted heap fallbacks
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Arena header rounded up so the buffer behind it stays aligned */
+#define ARENA_HEADER_SIZE ((sizeof(Arena) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+/* Process-wide counters; arenas can be created from any thread */
+static AllocStats alloc_stats;
+
+/**
+ * Count one allocation
+ */
+static void count_alloc(uint64_t *allocs, uint64_t *bytes, size_t size) {
+    __atomic_fetch_add(allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(bytes, (uint64_t)size, __ATOMIC_RELAXED);
+}
+
+/**
+ * Create an arena
+ */
+Arena* arena_create(size_t capacity) {
+    void *block = NULL;
+    if (posix_memalign(&block, ARENA_ALIGN, ARENA_HEADER_SIZE + capacity) != 0) {
+        return NULL;
+    }
+    count_alloc(&alloc_stats.heap_allocs, &alloc_stats.heap_bytes, ARENA_HEADER_SIZE + capacity);
+    
+    Arena *arena = block;
+    arena->base = (unsigned char *)block + ARENA_HEADER_SIZE;
+    arena->capacity = capacity;
+    arena->used = 0;
+    arena->keep = 0;
+    return arena;
+}
+
+/**
+ * Free an arena
+ */
+void arena_free(Arena *arena) {
+    free(arena);
+}
+
+/**
+ * Bump-allocate
+ */
+void* arena_alloc(Arena *arena, size_t size) {
+    if (!arena) return NULL;
+    
+    size_t at = (arena->used + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (at > arena->capacity || size > arena->capacity - at) {
+        return NULL;
+    }
+    
+    arena->used = at + size;
+    count_alloc(&alloc_stats.arena_allocs, &alloc_stats.arena_bytes, size);
+    return arena->base + at;
+}
+
+/**
+ * Move the reset point to the current offset
+ */
+void arena_keep(Arena *arena) {
+    if (arena) {
+        arena->keep = arena->used;
+    }
+}
+
+/**
+ * Drop allocations above the reset point
+ */
+void arena_reset(Arena *arena) {
+    if (arena) {
+        arena->used = arena->keep;
+    }
+}
+
+/**
+ * Counted malloc
+ */
+void* arena_heap_alloc(size_t size) {
+    void *block = malloc(size);
+    if (block) {
+        count_alloc(&alloc_stats.heap_allocs, &alloc_stats.heap_bytes, size);
+    }
+    return block;
+}
+
+/**
+ * Counted calloc
+ */
+void* arena_heap_calloc(size_t size) {
+    void *block = arena_heap_alloc(size);
+    if (block) {
+        memset(block, 0, size);
+    }
+    return block;
+}
+
+/**
+ * Free a counted heap block
+ */
+void arena_heap_free(void *block) {
+    free(block);
+}
+
+/**
+ * Total allocations so far
+ */
+uint64_t arena_alloc_count(void) {
+    return __atomic_load_n(&alloc_stats.heap_allocs, __ATOMIC_RELAXED) +
+           __atomic_load_n(&alloc_stats.arena_allocs, __ATOMIC_RELAXED);
+}
+
+/**
+ * Copy the counters
+ */
+void arena_stats(AllocStats *stats) {
+    if (!stats) return;
+    
+    stats->heap_allocs = __atomic_load_n(&alloc_stats.heap_allocs, __ATOMIC_RELAXED);
+    stats->heap_bytes = __atomic_load_n(&alloc_stats.heap_bytes, __ATOMIC_RELAXED);
+    stats->arena_allocs = __atomic_load_n(&alloc_stats.arena_allocs, __ATOMIC_RELAXED);
+    stats->arena_bytes = __atomic_load_n(&alloc_stats.arena_bytes, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,765 @@
+/*
+ * Space Invaders - Benchmarks
+ * Each benchmark drives the model directly; only the tty and sdl benchmarks
+ * run views, inside a pseudo-terminal or on offscreen SDL windows
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+#include "model.h"
+#include "config.h"
+#include "controller.h"
+#include "log.h"
+#include "profile.h"
+#include "utils.h"
+#include "view_ncurses.h"
+#include "view_ansi.h"
+#include "scene.h"
+#include "view_sdl.h"
+#include <SDL3/SDL.h>
+#include <errno.h>
+#include <math.h>
+#include <pty.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Benchmark entry */
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*run)(void);
+} Bench;
+
+/* Fixed seed so runs are comparable */
+#define BENCH_SEED 12345
+
+/**
+ * Monotonic clock in nanoseconds
+ */
+static double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Keep the optimizer from discarding a result
+ */
+static volatile int bench_sink;
+
+/**
+ * Snapshot/restore throughput on a 64-frame ring
+ */
+static int bench_snapshot(void) {
+    const int capacity = 64;
+    const int iterations = 200000;
+    const int rollback = 8;
+    
+    GameState *state = game_init_seeded(BENCH_SEED);
+    SnapshotRing *ring = state ? game_snapshot_ring_create(state, capacity) : NULL;
+    if (!state || !ring) {
+        game_free(state);
+        game_snapshot_ring_free(ring);
+        return EXIT_FAILURE;
+    }
+    
+    /* Warm the ring with real frames */
+    for (int f = 0; f < capacity; f++) {
+        game_update(state);
+        game_snapshot(ring, state);
+    }
+    
+    double t0 = bench_now_ns();
+    for (int i = 0; i < iterations; i++) {
+        game_snapshot(ring, state);
+    }
+    double snapshot_ns = (bench_now_ns() - t0) / iterations;
+    
+    /* Fill the ring untimed, then time the restores it can serve */
+    double restore_total = 0;
+    int restores = 0;
+    while (restores < iterations) {
+        for (int k = 0; k < capacity; k++) {
+            game_snapshot(ring, state);
+        }
+        t0 = bench_now_ns();
+        while (ring->count > rollback) {
+            game_restore(ring, state, rollback);
+            restores++;
+        }
+        restore_total += bench_now_ns() - t0;
+    }
+    double restore_ns = restore_total / restores;
+    
+    /* Rollback netcode shape: restore 8 back, resimulate and re-record 8 frames */
+    t0 = bench_now_ns();
+    for (int i = 0; i < iterations / 10; i++) {
+        game_restore(ring, state, rollback);
+        for (int k = 0; k < rollback; k++) {
+            game_update(state);
+            game_snapshot(ring, state);
+        }
+    }
+    double resim_ns = (bench_now_ns() - t0) / (iterations / 10);
+    bench_sink = state->player.score;
+    
+    printf("snapshot: GameState is %zu bytes, ring of %d frames (%zu KiB)\n",
+           state->size, capacity, capacity * state->size / 1024);
+    printf("snapshot: %.1f ns/snapshot (%.2f GB/s)\n",
+           snapshot_ns, state->size / snapshot_ns);
+    printf("snapshot: %.1f ns/restore %d frames back\n", restore_ns, rollback);
+    printf("snapshot: %.1f ns per rollback of %d frames with resimulation\n",
+           resim_ns, rollback);
+    
+    game_snapshot_ring_free(ring);
+    game_free(state);
+    return EXIT_SUCCESS;
+}
+
+/* Projectile layout before the dense pools: flagged slots compacted per frame */
+typedef struct {
+    int x, y;
+    bool active;
+} BenchFlaggedShot;
+
+/**
+ * Baseline: flag pass plus compaction pass, as update_projectiles used to do
+ */
+static int bench_compact_step(BenchFlaggedShot *shots, int count, int dy) {
+    for (int i = 0; i < count; i++) {
+        if (!shots[i].active) continue;
+        shots[i].y += dy;
+        if (shots[i].y - dy <= 0) shots[i].active = false;
+    }
+    int new_count = 0;
+    for (int i = 0; i < count; i++) {
+        if (shots[i].active) shots[new_count++] = shots[i];
+    }
+    return new_count;
+}
+
+/**
+ * Advance + refill throughput of a dense projectile pool against the old
+ * compaction scheme, with 100 to 10000 live shots
+ */
+static int bench_projectiles(void) {
+    const int sizes[] = {100, 1000, 10000};
+    const long shot_updates = 20000000;  /* per size, so every size does equal work */
+    
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int live = sizes[s];
+        int frames = (int)(shot_updates / live);
+        Projectile *pool = malloc((size_t)live * sizeof(Projectile));
+        BenchFlaggedShot *flagged = malloc((size_t)live * sizeof(BenchFlaggedShot));
+        if (!pool || !flagged) {
+            free(pool);
+            free(flagged);
+            return EXIT_FAILURE;
+        }
+        
+        /* Same spread of heights for both; shots rise one row per frame and
+         * are refilled at the bottom, so ~1/BOARD_HEIGHT leave every frame */
+        for (int i = 0; i < live; i++) {
+            pool[i].x = flagged[i].x = i % BOARD_WIDTH;
+            pool[i].y = flagged[i].y = i % BOARD_HEIGHT;
+            flagged[i].active = true;
+        }
+        
+        int count = live;
+        double t0 = bench_now_ns();
+        for (int f = 0; f < frames; f++) {
+            count = game_advance_projectiles(pool, count, -1, BOARD_HEIGHT);
+            Projectile *p;
+            while ((p = game_projectile_alloc(pool, &count, live)) != NULL) {
+                p->x = f % BOARD_WIDTH;
+                p->y = BOARD_HEIGHT - 1;
+            }
+        }
+        double pool_ns = (bench_now_ns() - t0) / frames;
+        bench_sink = count;
+        
+        count = live;
+        t0 = bench_now_ns();
+        for (int f = 0; f < frames; f++) {
+            count = bench_compact_step(flagged, count, -1);
+            while (count < live) {
+                flagged[count].x = f % BOARD_WIDTH;
+                flagged[count].y = BOARD_HEIGHT - 1;
+                flagged[count].active = true;
+                count++;
+            }
+        }
+        double compact_ns = (bench_now_ns() - t0) / frames;
+        bench_sink = count;
+        
+        printf("projectiles: %5d live: pool %9.1f ns/frame (%.2f ns/shot), "
+               "compaction %9.1f ns/frame (%.2f ns/shot)\n",
+               live, pool_ns, pool_ns / live, compact_ns, compact_ns / live);
+        
+        free(pool);
+        free(flagged);
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Step a batch of games with a trigger-happy bot for `frames` frames
+ * Returns elapsed nanoseconds
+ */
+static double bench_log_run(GameState **states, int games, int frames) {
+    ActionSet actions[64];
+    
+    double t0 = bench_now_ns();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < games; i++) {
+            int phase = (f + i) % 8;
+            actions[i] = phase < 3 ? ACTION_SHOOT : phase < 5 ? ACTION_LEFT : ACTION_RIGHT;
+        }
+        controller_update_batch(states, actions, games);
+        for (int i = 0; i < games; i++) {
+            if (game_is_over(states[i])) game_reset(states[i]);
+        }
+    }
+    return bench_now_ns() - t0;
+}
+
+/**
+ * game_update cost with the event log disabled and enabled, plus the
+ * producer cost of one record against an unbuffered fprintf (the old
+ * stderr path)
+ */
+static int bench_log(void) {
+    const int games = 64;
+    const int frames = 20000;
+    const int records = 1000000;
+    GameState *states[64];
+    for (int i = 0; i < games; i++) {
+        states[i] = game_init_seeded(BENCH_SEED + (uint64_t)i);
+        if (!states[i]) {
+            while (i-- > 0) game_free(states[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    double off_ns = bench_log_run(states, games, frames) / ((double)games * frames);
+    
+    if (!log_init("/dev/null")) {
+        for (int i = 0; i < games; i++) game_free(states[i]);
+        return EXIT_FAILURE;
+    }
+    uint64_t written0, dropped0;
+    log_stats(&written0, &dropped0);
+    for (int i = 0; i < games; i++) game_reset_seeded(states[i], BENCH_SEED + (uint64_t)i);
+    double on_ns = bench_log_run(states, games, frames) / ((double)games * frames);
+    
+    /* Raw producer cost; pace in bursts the drain thread can keep up with */
+    double ring_total = 0;
+    for (int done = 0; done < records; done += LOG_RING_SIZE / 2) {
+        double t0 = bench_now_ns();
+        for (int k = 0; k < LOG_RING_SIZE / 2; k++) {
+            log_event(LOG_EV_PLAYER_SHOOT, done + k, k, 21, 0, 0, 0, 0);
+        }
+        ring_total += bench_now_ns() - t0;
+        struct timespec wait = {0, 2000000L};
+        nanosleep(&wait, NULL);
+    }
+    log_shutdown();
+    uint64_t written, dropped;
+    log_stats(&written, &dropped);
+    
+    FILE *unbuffered = fopen("/dev/null", "w");
+    double fprintf_ns = 0;
+    if (unbuffered) {
+        setvbuf(unbuffered, NULL, _IONBF, 0);
+        double t0 = bench_now_ns();
+        for (int k = 0; k < records; k++) {
+            fprintf(unbuffered, "PLAYER SHOOT: projectile created at (%d,%d)\n", k, 21);
+        }
+        fprintf_ns = (bench_now_ns() - t0) / records;
+        fclose(unbuffered);
+    }
+    
+#if LOG_LEVEL < LOG_LEVEL_DEBUG
+    printf("log: built with LOG_LEVEL=%d, shot/hit events are compiled out\n", LOG_LEVEL);
+#endif
+    printf("log: game_update %.1f ns/frame logging off, %.1f ns/frame logging on\n",
+           off_ns, on_ns);
+    printf("log: %llu records written, %llu dropped on full rings\n",
+           (unsigned long long)(written - written0), (unsigned long long)(dropped - dropped0));
+    printf("log: %.1f ns/record into the ring vs %.1f ns/record via unbuffered fprintf\n",
+           ring_total / records, fprintf_ns);
+    
+    for (int i = 0; i < games; i++) game_free(states[i]);
+    return EXIT_SUCCESS;
+}
+
+/* Pacing bench: ticks timed per loop */
+#define PACING_TICKS 180
+
+/**
+ * Wall-clock milliseconds, as the game loop used to read them
+ */
+static unsigned long pacing_legacy_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (unsigned long)ts.tv_sec * 1000 + (unsigned long)ts.tv_nsec / 1000000;
+}
+
+/**
+ * Old game_loop pacing: millisecond wall clock, integer 16 ms frame and a
+ * fixed 5 ms sleep per iteration. Fills `stamps` with tick times.
+ */
+static void pacing_run_legacy(uint64_t *stamps, int ticks) {
+    const unsigned long frame_time_ms = 1000 / TARGET_FPS;
+    const struct timespec nap = {0, 5000000L};
+    unsigned long last_time = pacing_legacy_ms();
+    unsigned long lag = 0;
+    int n = 0;
+    
+    while (n < ticks) {
+        unsigned long current_time = pacing_legacy_ms();
+        lag += current_time - last_time;
+        last_time = current_time;
+        while (lag >= frame_time_ms && n < ticks) {
+            stamps[n++] = utils_time_ns();
+            lag -= frame_time_ms;
+        }
+        nanosleep(&nap, NULL);
+    }
+}
+
+/**
+ * Current game_loop pacing: pacer deadlines and absolute sleeps
+ */
+static void pacing_run_deadline(uint64_t *stamps, int ticks, int rate) {
+    Pacer pacer;
+    utils_pacer_start(&pacer, rate, utils_time_ns());
+    int n = 0;
+    
+    while (n < ticks) {
+        int due = utils_pacer_due(&pacer, utils_time_ns(), GAME_MAX_CATCHUP_TICKS);
+        while (due-- > 0 && n < ticks) {
+            stamps[n++] = utils_time_ns();
+        }
+        utils_sleep_until_ns(utils_pacer_next(&pacer));
+    }
+}
+
+/**
+ * qsort order for doubles
+ */
+static int pacing_cmp(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Print tick-interval statistics against the ideal interval
+ */
+static void pacing_report(const char *name, const uint64_t *stamps, int ticks, int rate) {
+    double ideal_us = 1e6 / rate;
+    double sum = 0, sum_sq = 0;
+    double err[PACING_TICKS * 4];
+    int n = ticks - 1;
+    
+    for (int i = 0; i < n; i++) {
+        double interval_us = (stamps[i + 1] - stamps[i]) / 1000.0;
+        sum += interval_us;
+        sum_sq += interval_us * interval_us;
+        err[i] = fabs(interval_us - ideal_us);
+    }
+    qsort(err, (size_t)n, sizeof(double), pacing_cmp);
+    
+    double mean = sum / n;
+    printf("pacing: %-16s %6.1f Hz  mean %7.1f us  stddev %6.1f us  |err| p50 %6.1f  p90 %6.1f  p99 %7.1f us\n",
+           name, 1e6 / mean, mean, sqrt(sum_sq / n - mean * mean),
+           err[n / 2], err[n * 9 / 10], err[n * 99 / 100]);
+}
+
+/**
+ * Tick-interval jitter of the old and current game loop pacing
+ */
+static int bench_pacing(void) {
+    static uint64_t stamps[PACING_TICKS * 4];
+    
+    printf("pacing: %d ticks per run, ideal interval %.1f us at %d Hz\n",
+           PACING_TICKS, 1e6 / TARGET_FPS, TARGET_FPS);
+    
+    pacing_run_legacy(stamps, PACING_TICKS);
+    pacing_report("ms clock + 5 ms", stamps, PACING_TICKS, TARGET_FPS);
+    
+    pacing_run_deadline(stamps, PACING_TICKS, TARGET_FPS);
+    pacing_report("deadline 60 Hz", stamps, PACING_TICKS, TARGET_FPS);
+    
+    pacing_run_deadline(stamps, PACING_TICKS * 4, TARGET_FPS * 4);
+    pacing_report("deadline 240 Hz", stamps, PACING_TICKS * 4, TARGET_FPS * 4);
+    
+    return EXIT_SUCCESS;
+}
+
+/* Tty bench: frames drawn per view, and the pseudo-terminal they draw into */
+#define TTY_FRAMES 3000
+#define TTY_ROWS 30
+#define TTY_COLS 120
+
+/* A terminal view as the tty bench drives it */
+typedef struct {
+    const char *name;
+    bool (*init)(const GameConfig *config);
+    void (*cleanup)(void);
+    void (*render)(const GameState *state, const Scene *scene);
+    void (*present)(void);
+} TtyView;
+
+/**
+ * Child side: play `frames` frames with a bot, rendering and presenting
+ * every one of them, as fast as the terminal takes them
+ */
+static void tty_play(const TtyView *view, int frames) {
+    GameState *state = game_init_seeded(BENCH_SEED);
+    Scene *scene = state ? scene_create(&state->config) : NULL;
+    if (!scene || !view->init(&state->config)) _exit(EXIT_FAILURE);
+    
+    for (int f = 0; f < frames; f++) {
+        int phase = f % 16;
+        ActionSet action = phase == 0 ? ACTION_SHOOT : phase < 6 ? ACTION_LEFT :
+                           phase < 8 ? 0 : phase < 13 ? ACTION_RIGHT : 0;
+        controller_update_batch(&state, &action, 1);
+        if (game_is_over(state)) game_reset(state);
+        scene_build(scene, state);
+        view->render(state, scene);
+        view->present();
+    }
+    
+    view->cleanup();
+    scene_free(scene);
+    game_free(state);
+    _exit(EXIT_SUCCESS);
+}
+
+/**
+ * Run one view in a fresh pseudo-terminal and count what it writes
+ */
+static int tty_run(const TtyView *view, int frames) {
+    struct winsize size = {.ws_row = TTY_ROWS, .ws_col = TTY_COLS};
+    int master;
+    
+    double t0 = bench_now_ns();
+    pid_t pid = forkpty(&master, NULL, NULL, &size);
+    if (pid < 0) {
+        fprintf(stderr, "tty: forkpty failed\n");
+        return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+        setenv("TERM", "xterm-256color", 0);
+        tty_play(view, frames);
+    }
+    
+    /* Drain until the child closes the terminal (EIO on Linux) */
+    static char buf[65536];
+    unsigned long long bytes = 0;
+    for (;;) {
+        ssize_t n = read(master, buf, sizeof(buf));
+        if (n > 0) {
+            bytes += (unsigned long long)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    double elapsed_ns = bench_now_ns() - t0;
+    close(master);
+    
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        fprintf(stderr, "tty: %s view failed in the pty\n", view->name);
+        return EXIT_FAILURE;
+    }
+    
+    printf("tty: %-8s %8llu bytes  %8.1f bytes/frame  %7.1f us/frame\n",
+           view->name, bytes, (double)bytes / frames, elapsed_ns / 1000.0 / frames);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Bytes and time per frame each terminal view writes to a pty during bot play
+ */
+static int bench_tty(void) {
+    static const TtyView views[] = {
+        {"ncurses", view_ncurses_init, view_ncurses_cleanup, view_ncurses_render, view_ncurses_present},
+        {"ansi", view_ansi_init, view_ansi_cleanup, view_ansi_render, view_ansi_present},
+    };
+    
+    printf("tty: %d frames of bot play per view on a %dx%d pty\n", TTY_FRAMES, TTY_COLS, TTY_ROWS);
+    for (size_t i = 0; i < sizeof(views) / sizeof(views[0]); i++) {
+        if (tty_run(&views[i], TTY_FRAMES) != EXIT_SUCCESS) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* SDL bench: frames drawn per renderer and mode, on offscreen windows */
+#define SDL_BENCH_FRAMES 600
+#define SDL_BENCH_CELL 24.0f  /* CELL_SIZE of the SDL view */
+
+typedef enum {
+    SDL_BENCH_PER_RECT,   /* fills as the view drew them before batching */
+    SDL_BENCH_BATCHED,    /* view_sdl_render */
+    SDL_BENCH_OVERLAY     /* view_sdl_render with the profiler overlay's text */
+} SdlBenchMode;
+
+static const char *const sdl_bench_modes[] = {"per-rect", "batched", "overlay"};
+
+/**
+ * The view's drawing before batching: a color change and a fill call for
+ * every rectangle. Returns the renderer calls made.
+ */
+static int sdl_render_per_rect(SDL_Renderer *renderer, const Scene *scene) {
+    int calls = 2;
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        int count;
+        const SceneRect *rect = scene_group(scene, (Material)m, &count);
+        for (int r = 0; r < count; r++, rect++) {
+            SDL_FRect px = {
+                .x = rect->x * SDL_BENCH_CELL, .y = rect->y * SDL_BENCH_CELL,
+                .w = rect->w * SDL_BENCH_CELL, .h = rect->h * SDL_BENCH_CELL
+            };
+            SDL_SetRenderDrawColor(renderer, (Uint8)(m * 40), (Uint8)(255 - m * 30), 128, 255);
+            SDL_RenderFillRect(renderer, &px);
+            calls += 2;
+        }
+    }
+    
+    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
+    SDL_RenderLine(renderer, 0, (BOARD_HEIGHT + 1) * SDL_BENCH_CELL,
+                   BOARD_WIDTH * SDL_BENCH_CELL, (BOARD_HEIGHT + 1) * SDL_BENCH_CELL);
+    return calls + 2;
+}
+
+/**
+ * Play SDL_BENCH_FRAMES bot frames through the SDL view on the current
+ * drivers in one drawing mode, and report calls and time
+ */
+static void sdl_bench_mode(const char *renderer_name, SdlBenchMode mode) {
+    GameState *state = game_init_seeded(BENCH_SEED);
+    Scene *scene = state ? scene_create(&state->config) : NULL;
+    int window_count = 0;
+    SDL_Window **windows = SDL_GetWindows(&window_count);
+    SDL_Renderer *renderer = windows && window_count > 0 ? SDL_GetRenderer(windows[0]) : NULL;
+    SDL_free(windows);
+    if (!scene || !renderer) {
+        scene_free(scene);
+        game_free(state);
+        return;
+    }
+    
+    /* The overlay refreshes its text every PROFILE_OVERLAY_WINDOW frames
+     * from the render times recorded here */
+    if (mode == SDL_BENCH_OVERLAY) profile_enable();
+    
+    long calls = 0;
+    double render_ns = 0;
+    double t0 = bench_now_ns();
+    for (int f = 0; f < SDL_BENCH_FRAMES; f++) {
+        int phase = f % 16;
+        ActionSet action = phase == 0 ? ACTION_SHOOT : phase < 6 ? ACTION_LEFT :
+                           phase < 8 ? 0 : phase < 13 ? ACTION_RIGHT : 0;
+        controller_update_batch(&state, &action, 1);
+        if (game_is_over(state)) game_reset(state);
+        scene_build(scene, state);
+        double r0 = bench_now_ns();
+        if (mode == SDL_BENCH_PER_RECT) {
+            calls += sdl_render_per_rect(renderer, scene);
+        } else {
+            view_sdl_render(state, scene);
+            calls += view_sdl_draw_calls();
+        }
+        double r1 = bench_now_ns();
+        render_ns += r1 - r0;
+        view_sdl_present();
+        if (mode == SDL_BENCH_OVERLAY) {
+            profile_record(PROFILE_RENDER, (uint64_t)(r1 - r0));
+            profile_frame_end();
+        }
+    }
+    double elapsed_ns = bench_now_ns() - t0;
+    if (mode == SDL_BENCH_OVERLAY) profile_toggle_overlay();
+    
+    printf("sdl: %-10s %-9s %6.1f calls/frame  submit %6.1f us  frame %8.1f us\n", renderer_name,
+           sdl_bench_modes[mode], (double)calls / SDL_BENCH_FRAMES,
+           render_ns / 1000.0 / SDL_BENCH_FRAMES, elapsed_ns / 1000.0 / SDL_BENCH_FRAMES);
+    scene_free(scene);
+    game_free(state);
+}
+
+/**
+ * SDL renderer calls and frame time, one fill call per entity vs one per
+ * material, and with the overlay's text, on the software renderer and the
+ * offscreen driver's default
+ */
+static int bench_sdl(void) {
+    static const char *const render_drivers[] = {"software", NULL};
+    GameConfig config;
+    game_config_default(&config);
+    
+    printf("sdl: %d frames of bot play per mode, offscreen video driver\n", SDL_BENCH_FRAMES);
+    for (size_t i = 0; i < sizeof(render_drivers) / sizeof(render_drivers[0]); i++) {
+        /* SDL_Quit (view cleanup) drops hints: set them for every run */
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        if (render_drivers[i]) {
+            SDL_SetHint(SDL_HINT_RENDER_DRIVER, render_drivers[i]);
+        } else {
+            SDL_ResetHint(SDL_HINT_RENDER_DRIVER);
+        }
+        if (!view_sdl_init(&config)) {
+            printf("sdl: %s renderer unavailable\n", render_drivers[i] ? render_drivers[i] : "default");
+            continue;
+        }
+        
+        int window_count = 0;
+        SDL_Window **windows = SDL_GetWindows(&window_count);
+        const char *name = window_count > 0 ? SDL_GetRendererName(SDL_GetRenderer(windows[0])) : NULL;
+        char label[32];
+        snprintf(label, sizeof(label), "%s", name ? name : "?");
+        SDL_free(windows);
+        
+        sdl_bench_mode(label, SDL_BENCH_PER_RECT);
+        sdl_bench_mode(label, SDL_BENCH_BATCHED);
+        sdl_bench_mode(label, SDL_BENCH_OVERLAY);
+        view_sdl_cleanup();
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Stress mode: formation sizes grow by STRESS_GROWTH per step from the
+ * classic board, ending near half a million enemies */
+#define STRESS_STEPS 8
+#define STRESS_GROWTH 4
+
+/**
+ * Board for a formation of `enemies` slots: twice as many columns as rows
+ * at the tightest pitch, room to sweep a quarter of its width, shields and
+ * projectile pools scaled with the board
+ */
+static void stress_config(GameConfig *config, int enemies) {
+    game_config_default(config);
+    if (enemies <= config->enemy_count) return;
+    
+    int cols = 1;
+    while ((long)cols * cols < 2L * enemies) cols++;
+    int rows = (enemies + cols - 1) / cols;
+    
+    config->enemy_count = enemies;
+    config->enemy_cols = cols;
+    config->enemy_spacing_x = ENEMY_WIDTH + 1;
+    config->enemy_spacing_y = ENEMY_HEIGHT + 1;
+    
+    int width = (cols - 1) * config->enemy_spacing_x + ENEMY_WIDTH;
+    int height = (rows - 1) * config->enemy_spacing_y + ENEMY_HEIGHT;
+    int scale = 1;
+    if (width + width / 4 + 2 * ENEMY_START_X > BOARD_WIDTH) {
+        config->board_width = width + width / 4 + 2 * ENEMY_START_X;
+        scale = config->board_width / BOARD_WIDTH;
+    }
+    /* Below the formation, the classic board's room for shields and player */
+    config->board_height = ENEMY_START_Y + height + BOARD_HEIGHT;
+    config->max_projectiles = MAX_PROJECTILES > config->board_height ?
+                              MAX_PROJECTILES : config->board_height;
+    config->max_enemy_projectiles = MAX_ENEMY_PROJECTILES * scale;
+    config->shield_count = SHIELD_COUNT * scale;
+}
+
+/**
+ * Stress mode
+ */
+int bench_stress(int frames, uint64_t seed) {
+    printf("stress: %d frames per size, seed %llu\n", frames, (unsigned long long)seed);
+    printf("stress: %9s %11s %10s %10s %10s %12s %9s\n",
+           "enemies", "board", "state KiB", "init us", "ns/frame", "shots/frame", "restarts");
+    
+    int enemies = INITIAL_ENEMIES;
+    for (int step = 0; step < STRESS_STEPS; step++, enemies *= STRESS_GROWTH) {
+        GameConfig config;
+        stress_config(&config, enemies);
+        
+        double t0 = bench_now_ns();
+        GameState *state = game_init_ex(&config, seed);
+        double init_us = (bench_now_ns() - t0) / 1000.0;
+        if (!state) {
+            fprintf(stderr, "stress: cannot allocate a board for %d enemies\n", enemies);
+            return EXIT_FAILURE;
+        }
+        
+        /* Resets rebuild the whole formation; keep them out of the frame cost */
+        double reset_ns = 0;
+        long shots = 0;
+        int restarts = 0;
+        t0 = bench_now_ns();
+        for (int f = 0; f < frames; f++) {
+            int phase = f % 8;
+            ActionSet action = phase < 3 ? ACTION_SHOOT : phase < 5 ? ACTION_LEFT : ACTION_RIGHT;
+            controller_update_batch(&state, &action, 1);
+            shots += state->projectile_count + state->enemy_projectile_count;
+            if (game_is_over(state)) {
+                double r0 = bench_now_ns();
+                game_reset(state);
+                reset_ns += bench_now_ns() - r0;
+                restarts++;
+            }
+        }
+        double frame_ns = (bench_now_ns() - t0 - reset_ns) / frames;
+        
+        char board[24];
+        snprintf(board, sizeof(board), "%dx%d", config.board_width, config.board_height);
+        printf("stress: %9d %11s %10.1f %10.1f %10.1f %12.1f %9d\n",
+               enemies, board, state->size / 1024.0, init_us, frame_ns,
+               (double)shots / frames, restarts);
+        
+        game_free(state);
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+/* Available benchmarks */
+static const Bench benches[] = {
+    {"snapshot", "GameState snapshot/restore throughput on a rollback ring", bench_snapshot},
+    {"projectiles", "Dense projectile pool vs per-frame compaction, 100-10000 live shots", bench_projectiles},
+    {"log", "game_update with the event log off and on, ring vs fprintf record cost", bench_log},
+    {"pacing", "Game loop tick jitter: old ms clock + fixed sleep vs absolute deadlines", bench_pacing},
+    {"tty", "Bytes and time per frame the terminal views write to a pty", bench_tty},
+    {"sdl", "SDL renderer calls and time per frame: per-rect, batched, overlay text", bench_sdl},
+};
+
+/**
+ * Run a benchmark by name
+ */
+int bench_run(const char *name) {
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (strcmp(benches[i].name, name) == 0) {
+            return benches[i].run();
+        }
+    }
+    
+    fprintf(stderr, "Unknown benchmark: %s\n", name);
+    bench_list(stderr);
+    return EXIT_FAILURE;
+}
+
+/**
+ * List benchmarks
+ */
+void bench_list(FILE *out) {
+    fprintf(out, "Benchmarks:\n");
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        fprintf(out, "  %-12s %s\n", benches[i].name, benches[i].description);
+    }
+}
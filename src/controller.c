@@ -4,17 +4,23 @@
  */
 
 #include "controller.h"
+#include "config.h"
+#include "arena.h"
 #include <stdlib.h>
 
 /**
- * Initialize controller
+ * Initialize controller in the game's session arena
  */
 Controller* controller_init(GameState *state) {
-    Controller *ctrl = malloc(sizeof(Controller));
+    if (!state) return NULL;
+    
+    Controller *ctrl = arena_alloc(state->arena, sizeof(Controller));
     if (!ctrl) return NULL;
+    arena_keep(state->arena);  /* session object: survives game_reset */
     
     ctrl->game_state = state;
     ctrl->running = true;
+    ctrl->move_timer = 0;
     
     return ctrl;
 }
@@ -23,38 +29,59 @@ Controller* controller_init(GameState *state) {
  * Free controller
  */
 void controller_free(Controller *ctrl) {
-    if (ctrl) {
-        free(ctrl);
+    /* Arena memory: released with the game by game_free */
+    (void)ctrl;
+}
+
+/**
+ * Apply a set of gameplay actions to a game state
+ * Pause goes first so a tick that unpauses and moves does both
+ * Returns true if any action maps to a model action
+ */
+static bool apply_actions(GameState *state, ActionSet actions) {
+    if (actions & ACTION_PAUSE) game_toggle_pause(state);
+    if (actions & ACTION_LEFT) game_move_player_left(state);
+    if (actions & ACTION_RIGHT) game_move_player_right(state);
+    if (actions & ACTION_SHOOT) game_player_shoot(state);
+    return (actions & ACTION_GAME_MASK) != 0;
+}
+
+/**
+ * Resolve one frame of input
+ */
+ActionSet controller_frame_actions(Controller *ctrl, ActionSet pressed, ActionSet held) {
+    if (!ctrl) return 0;
+    
+    const ActionSet directions = ACTION_LEFT | ACTION_RIGHT;
+    ActionSet actions = pressed & ~directions;
+    
+    if (pressed & directions) {
+        /* A press steps at once; holding it repeats after a full period */
+        actions |= pressed & directions;
+        ctrl->move_timer = PLAYER_MOVE_PERIOD;
+    } else if (held & directions) {
+        if (--ctrl->move_timer <= 0) {
+            actions |= held & directions;
+            ctrl->move_timer = PLAYER_MOVE_PERIOD;
+        }
+    } else {
+        ctrl->move_timer = 0;
     }
+    return actions;
 }
 
 /**
- * Execute a command
+ * Execute actions
  */
-bool controller_execute_command(Controller *ctrl, Command cmd) {
+bool controller_execute_actions(Controller *ctrl, ActionSet actions) {
     if (!ctrl || !ctrl->game_state) return false;
     
-    switch (cmd) {
-        case CMD_MOVE_LEFT:
-            game_move_player_left(ctrl->game_state);
-            return true;
-        case CMD_MOVE_RIGHT:
-            game_move_player_right(ctrl->game_state);
-            return true;
-        case CMD_SHOOT:
-            game_player_shoot(ctrl->game_state);
-            return true;
-        case CMD_PAUSE:
-            game_toggle_pause(ctrl->game_state);
-            return true;
-        case CMD_QUIT:
-            ctrl->running = false;
-            return true;
-        case CMD_NONE:
-        case CMD_SWITCH_VIEW:
-        default:
-            return false;
+    if (actions & ACTION_QUIT) {
+        ctrl->running = false;
+        return true;
     }
+    
+    return apply_actions(ctrl->game_state, actions);
 }
 
 /**
@@ -69,6 +96,20 @@ void controller_update(Controller *ctrl) {
     }
 }
 
+/**
+ * Step a batch of independent games by one frame
+ */
+void controller_update_batch(GameState *const *states, const ActionSet *actions, int n) {
+    if (!states) return;
+    
+    for (int i = 0; i < n; i++) {
+        if (actions) {
+            apply_actions(states[i], actions[i]);
+        }
+        game_update(states[i]);
+    }
+}
+
 /**
  * Check if running
  */
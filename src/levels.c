@@ -0,0 +1,195 @@
+/*
+ * Space Invaders - Level Pack Implementation
+ * mmap the pack, check it once, then hand out records in place
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "levels.h"
+#include "config.h"
+#include "utils.h"
+#include "arena.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Live-cell mask of a full shield (same layout as the Shield masks) */
+#define LEVEL_SHIELD_COLUMN_FULL ((1ULL << SHIELD_HEIGHT) - 1)
+#define LEVEL_SHIELD_FULL_MASK (LEVEL_SHIELD_COLUMN_FULL * (0x0101010101010101ULL >> (SHIELD_COLUMN_BITS * (8 - SHIELD_WIDTH))))
+
+/* Largest formation a pack may describe, so mask sizes never overflow */
+#define LEVEL_PACK_MAX_ENEMIES (1u << 24)
+
+/**
+ * Record size
+ */
+size_t level_pack_record_size(int enemy_count, int shield_count) {
+    return sizeof(LevelRecord) + (size_t)((enemy_count + 63) / 64) * sizeof(uint64_t) +
+           (size_t)shield_count * sizeof(LevelShield);
+}
+
+/**
+ * FNV-1a
+ */
+uint32_t level_pack_checksum(const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    uint32_t h = 0x811c9dc5u;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+/**
+ * Check one level: sane timings, the live formation inside the board with
+ * room to move, shields on the board
+ * Returns an error message, or NULL if the level is playable
+ */
+static const char *check_level(const LevelPack *pack, const LevelRecord *record) {
+    const LevelPackHeader *h = pack->header;
+    const uint64_t *mask = level_pack_enemies(record);
+    int cols = h->enemy_cols;
+    
+    if (record->move_period < 1 || record->fire_period < 1 || record->shot_speed < 1) {
+        return "periods and shot speed must be positive";
+    }
+    if (record->aim_chance > 100) {
+        return "aim chance is a percentage";
+    }
+    
+    /* Live count and extents of the formation */
+    uint32_t alive = 0;
+    int left = cols, right = -1, bottom = -1;
+    for (int w = 0; w < pack->enemy_words; w++) {
+        if (w == pack->enemy_words - 1 && h->enemy_count % 64 &&
+            (mask[w] >> (h->enemy_count % 64)) != 0) {
+            return "enemy mask has bits past the last formation slot";
+        }
+        for (uint64_t m = mask[w]; m; m &= m - 1) {
+            int slot = w * 64 + utils_ctz64(m);
+            int col = slot % cols;
+            alive++;
+            if (col < left) left = col;
+            if (col > right) right = col;
+            bottom = slot / cols;
+        }
+    }
+    if (alive == 0 || alive != record->alive) {
+        return "enemy count does not match its mask";
+    }
+    if (record->origin_x + left * h->enemy_spacing_x < 1 ||
+        record->origin_x + right * h->enemy_spacing_x + ENEMY_WIDTH >= h->board_width ||
+        record->origin_y < 0 ||
+        record->origin_y + bottom * h->enemy_spacing_y >= h->board_height - 2) {
+        return "formation does not fit the board";
+    }
+    
+    const LevelShield *shields = level_pack_shields(pack, record);
+    for (int s = 0; s < h->shield_count; s++) {
+        if (shields[s].x < 0 || shields[s].x > h->board_width - SHIELD_WIDTH ||
+            shields[s].y < 0 || shields[s].y > h->board_height - 1 - SHIELD_HEIGHT) {
+            return "shield outside the board";
+        }
+        if (shields[s].mask & ~LEVEL_SHIELD_FULL_MASK) {
+            return "shield mask larger than a shield";
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Check the header and every level
+ * Returns an error message, or NULL if the pack is usable
+ */
+static const char *check_pack(const LevelPack *pack) {
+    const LevelPackHeader *h = pack->header;
+    
+    if (pack->map_size < sizeof(LevelPackHeader) || memcmp(h->magic, LEVEL_PACK_MAGIC, 4) != 0) {
+        return "not a level pack";
+    }
+    if (h->version != LEVEL_PACK_VERSION) {
+        return "unsupported level pack version";
+    }
+    if (h->level_count < 1 || h->enemy_count < 1 || h->enemy_count > LEVEL_PACK_MAX_ENEMIES ||
+        h->enemy_cols < 1 ||
+        h->enemy_spacing_x < ENEMY_WIDTH || h->enemy_spacing_y < ENEMY_HEIGHT) {
+        return "empty level pack or bad formation";
+    }
+    if (h->board_width < PLAYER_WIDTH || h->board_width < SHIELD_WIDTH ||
+        h->board_height < PLAYER_HEIGHT + 2 ||
+        h->board_width > INT16_MAX || h->board_height > INT16_MAX) {
+        return "board too small or too large";
+    }
+    if (h->record_size != level_pack_record_size((int)h->enemy_count, h->shield_count) ||
+        pack->map_size != sizeof(LevelPackHeader) + (size_t)h->level_count * h->record_size) {
+        return "size does not match its header";
+    }
+    if (h->checksum != level_pack_checksum(pack->map + sizeof(LevelPackHeader),
+                                           pack->map_size - sizeof(LevelPackHeader))) {
+        return "checksum mismatch";
+    }
+    
+    for (int level = 1; level <= h->level_count; level++) {
+        const char *error = check_level(pack, level_pack_level(pack, level));
+        if (error) return error;
+    }
+    return NULL;
+}
+
+/**
+ * Open pack
+ */
+LevelPack* level_pack_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Levels: cannot open %s\n", path);
+        return NULL;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(LevelPackHeader)) {
+        fprintf(stderr, "Levels: %s is not a level pack\n", path);
+        close(fd);
+        return NULL;
+    }
+    
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Levels: cannot map %s\n", path);
+        return NULL;
+    }
+    
+    LevelPack *pack = arena_heap_alloc(sizeof(LevelPack));
+    if (!pack) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    pack->map = map;
+    pack->map_size = (size_t)st.st_size;
+    pack->header = map;
+    pack->enemy_words = (int)((pack->header->enemy_count + 63) / 64);
+    
+    const char *error = check_pack(pack);
+    if (error) {
+        fprintf(stderr, "Levels: %s: %s\n", path, error);
+        level_pack_close(pack);
+        return NULL;
+    }
+    return pack;
+}
+
+/**
+ * Close pack
+ */
+void level_pack_close(LevelPack *pack) {
+    if (pack) {
+        munmap((void *)pack->map, pack->map_size);
+        arena_heap_free(pack);
+    }
+}
@@ -0,0 +1,220 @@
+/*
+ * Space Invaders - Event Log Implementation
+ * Per-thread SPSC rings drained by one background thread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "log.h"
+#include "arena.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Idle time of the drain thread when every ring is empty */
+#define LOG_DRAIN_IDLE_NS 1000000L
+
+/* Single-producer/single-consumer ring. head is written by the owning
+ * thread only, tail by the drain thread only; they sit on separate cache
+ * lines so the two sides do not contend. */
+typedef struct {
+    LogRecord records[LOG_RING_SIZE];
+    uint32_t head;      /* next slot to fill */
+    uint32_t pad_head[15];
+    uint32_t tail;      /* next slot to drain */
+    uint32_t pad_tail[15];
+    uint64_t dropped;   /* records lost to a full ring */
+} LogRing;
+
+/* Text for each event */
+static const struct {
+    const char *level;
+    const char *format;
+} log_formats[LOG_EV_COUNT] = {
+    [LOG_EV_PLAYER_SHOOT] = {"DEBUG", "PLAYER SHOOT: projectile created at (%d,%d)"},
+    [LOG_EV_ENEMY_SHOOT] = {"DEBUG", "ENEMY SHOOT: enemy projectile created at (%d,%d) from enemy at (%d,%d)"},
+    [LOG_EV_ENEMY_KILLED] = {"DEBUG", "HIT! Projectile (%d,%d) hit enemy (%d,%d)"},
+    [LOG_EV_PLAYER_HIT] = {"INFO", "ENEMY HIT! Enemy projectile (%d,%d) hit player at (%d,%d), health %d -> %d"},
+};
+
+/* Rings are created on a thread's first event and live for the whole
+ * process, so a thread never holds a dangling ring across log_init cycles */
+static LogRing *log_rings[LOG_MAX_THREADS];
+static uint32_t log_ring_count;
+static __thread LogRing *log_thread_ring;
+static __thread bool log_thread_failed;
+
+static int log_enabled;
+static int log_stopping;
+static uint64_t log_written;
+static FILE *log_fp;
+static pthread_t log_thread;
+
+/* The log file's stdio buffer; left to stdio it would be malloc'd by the
+ * drain thread's first write, in the middle of some frame */
+static char log_file_buf[BUFSIZ];
+
+/**
+ * Create and publish the calling thread's ring
+ */
+static LogRing *log_register(void) {
+    if (log_thread_failed) return NULL;
+    
+    LogRing *ring = arena_heap_calloc(sizeof(LogRing));
+    uint32_t slot = ring ? __atomic_fetch_add(&log_ring_count, 1, __ATOMIC_RELAXED) : LOG_MAX_THREADS;
+    if (slot >= LOG_MAX_THREADS) {
+        arena_heap_free(ring);
+        log_thread_failed = true;
+        return NULL;
+    }
+    
+    __atomic_store_n(&log_rings[slot], ring, __ATOMIC_RELEASE);
+    log_thread_ring = ring;
+    return ring;
+}
+
+/**
+ * Append an event
+ */
+void log_event(LogEvent event, int frame, int a, int b, int c, int d, int e, int f) {
+    if (!__atomic_load_n(&log_enabled, __ATOMIC_RELAXED)) return;
+    
+    LogRing *ring = log_thread_ring;
+    if (!ring && !(ring = log_register())) return;
+    
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail == LOG_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    LogRecord *rec = &ring->records[head & (LOG_RING_SIZE - 1)];
+    rec->event = (uint32_t)event;
+    rec->frame = frame;
+    rec->args[0] = a;
+    rec->args[1] = b;
+    rec->args[2] = c;
+    rec->args[3] = d;
+    rec->args[4] = e;
+    rec->args[5] = f;
+    
+    /* Publish the record */
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Format every published record of every ring
+ * Returns the number of records written
+ */
+static uint64_t log_drain(void) {
+    uint64_t drained = 0;
+    uint32_t count = __atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+    if (count > LOG_MAX_THREADS) count = LOG_MAX_THREADS;
+    
+    for (uint32_t t = 0; t < count; t++) {
+        LogRing *ring = __atomic_load_n(&log_rings[t], __ATOMIC_ACQUIRE);
+        if (!ring) continue;  /* slot claimed, ring not yet published */
+        
+        uint32_t tail = ring->tail;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        for (; tail != head; tail++) {
+            const LogRecord *rec = &ring->records[tail & (LOG_RING_SIZE - 1)];
+            if (rec->event < LOG_EV_COUNT) {
+                fprintf(log_fp, "[%d] %s t%u: ", rec->frame, log_formats[rec->event].level, t);
+                fprintf(log_fp, log_formats[rec->event].format, rec->args[0], rec->args[1],
+                        rec->args[2], rec->args[3], rec->args[4], rec->args[5]);
+                fputc('\n', log_fp);
+            }
+            drained++;
+        }
+        
+        /* Hand the slots back to the producer */
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    
+    __atomic_store_n(&log_written, log_written + drained, __ATOMIC_RELAXED);
+    return drained;
+}
+
+/**
+ * Drain thread: format until stopped, then empty the rings one last time
+ */
+static void *log_drain_main(void *arg) {
+    (void)arg;
+    struct timespec idle = {0, LOG_DRAIN_IDLE_NS};
+    
+    while (!__atomic_load_n(&log_stopping, __ATOMIC_ACQUIRE)) {
+        if (log_drain() == 0) {
+            fflush(log_fp);
+            nanosleep(&idle, NULL);
+        }
+    }
+    log_drain();
+    return NULL;
+}
+
+/**
+ * Open the log and start draining
+ */
+bool log_init(const char *path) {
+    if (log_fp) return true;
+    
+    log_fp = fopen(path, "w");
+    if (!log_fp) return false;
+    setvbuf(log_fp, log_file_buf, _IOFBF, sizeof(log_file_buf));
+    
+    log_stopping = 0;
+    log_written = 0;
+    
+    /* The opening thread is normally the one stepping the game: create its
+     * ring now rather than inside the first frame that logs */
+    if (!log_thread_ring) log_register();
+    
+    if (pthread_create(&log_thread, NULL, log_drain_main, NULL) != 0) {
+        fclose(log_fp);
+        log_fp = NULL;
+        return false;
+    }
+    
+    __atomic_store_n(&log_enabled, 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * Stop draining and close the log
+ */
+void log_shutdown(void) {
+    if (!log_fp) return;
+    
+    __atomic_store_n(&log_enabled, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&log_stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(log_thread, NULL);
+    
+    uint64_t written, dropped;
+    log_stats(&written, &dropped);
+    if (dropped > 0) {
+        fprintf(log_fp, "log: %llu records dropped on full rings\n", (unsigned long long)dropped);
+    }
+    
+    fclose(log_fp);
+    log_fp = NULL;
+}
+
+/**
+ * Written/dropped counters
+ */
+void log_stats(uint64_t *written, uint64_t *dropped) {
+    uint64_t lost = 0;
+    uint32_t count = __atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+    if (count > LOG_MAX_THREADS) count = LOG_MAX_THREADS;
+    
+    for (uint32_t t = 0; t < count; t++) {
+        LogRing *ring = __atomic_load_n(&log_rings[t], __ATOMIC_ACQUIRE);
+        if (ring) lost += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+    
+    if (written) *written = __atomic_load_n(&log_written, __ATOMIC_RELAXED);
+    if (dropped) *dropped = lost;
+}
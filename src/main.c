@@ -3,39 +3,111 @@
  * Orchestrates the MVC components
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "model.h"
 #include "controller.h"
 #include "utils.h"
 #include "config.h"
 #include "view_ncurses.h"
 #include "view_sdl.h"
+#include "view_ansi.h"
+#include "bench.h"
+#include "replay.h"
+#include "log.h"
+#include "arena.h"
+#include "alloc_count.h"
+#include "levels.h"
+#include "profile.h"
+#include "scene.h"
 
+#include <dlfcn.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <pty.h>
 
 /* View type enum */
 typedef enum {
     VIEW_NCURSES,
-    VIEW_SDL
+    VIEW_SDL,
+    VIEW_ANSI
 } ViewType;
 
 /* View interface */
 typedef struct {
-    bool (*init)(void);
+    bool (*init)(const GameConfig *config);
     void (*cleanup)(void);
-    void (*render)(const GameState *state);
-    Command (*handle_input)(void);
+    void (*render)(const GameState *state, const Scene *scene);
+    void (*present)(void);
+    TickInput (*handle_input)(void);
     void (*show_pause)(void);
     void (*show_game_over)(const GameState *state);
     Command (*show_menu)(void);
 } ViewInterface;
 
+/* Headless mode defaults */
+#define HEADLESS_DEFAULT_FRAMES 10000
+#define HEADLESS_DEFAULT_GAMES 1024
+#define HEADLESS_MAX_THREADS 256
+
+/* Headless run parameters */
+typedef struct {
+    int frames;
+    int games;
+    int threads;
+    int start_level;
+    uint64_t seed;
+} HeadlessOptions;
+
+/* One worker's share of a headless batch */
+typedef struct {
+    const HeadlessOptions *opts;
+    GameState **states;
+    ActionSet *actions;
+    unsigned int *action_seeds;
+    int count;
+    unsigned long restarts;
+} HeadlessSlice;
+
+/* Tick rate of --check-alloc: one frame per tick, with ticks due faster
+ * than the loop runs, so the view draws after every GAME_MAX_CATCHUP_TICKS
+ * frames and the check is still quick */
+#define ALLOC_CHECK_TICK_RATE 1000000
+
+/* Projectile speeds --check-sweep runs, 1 cell per frame up to this */
+#define SWEEP_CHECK_MAX_SPEED 10
+
+/* Per-frame allocation accounting: run_ticks samples the allocation counter
+ * (arena_alloc_count, or the C allocator calls counted by the preloaded
+ * alloc_count.so during --check-alloc) after every simulated frame,
+ * game_loop after every scene build, render and present */
+typedef struct {
+    uint64_t last;                     /* counter at the previous sample */
+    unsigned long frames;              /* frames simulated */
+    unsigned long allocating_frames;   /* frames that allocated anything */
+    unsigned long renders;             /* frames drawn */
+    unsigned long allocating_renders;  /* draws that allocated anything */
+    uint64_t allocs;                   /* allocations made inside either */
+} AllocWatch;
+
 /* Current view interface */
 static ViewInterface view_interface;
 
+/* Allocation accounting for the running session */
+static AllocWatch alloc_watch;
+
+/* Counter of the preloaded alloc_count.so, NULL unless --check-alloc found it */
+static const uint64_t *libc_alloc_calls;
+
+/* Level layouts for every game of the session, NULL for the built-in ones */
+static LevelPack *level_pack;
+
 /**
  * Select view based on type
  */
@@ -44,6 +116,7 @@ static bool select_view(ViewType type) {
         view_interface.init = view_ncurses_init;
         view_interface.cleanup = view_ncurses_cleanup;
         view_interface.render = view_ncurses_render;
+        view_interface.present = view_ncurses_present;
         view_interface.handle_input = view_ncurses_handle_input;
         view_interface.show_pause = view_ncurses_show_pause;
         view_interface.show_game_over = view_ncurses_show_game_over;
@@ -55,6 +128,7 @@ static bool select_view(ViewType type) {
         view_interface.init = view_sdl_init;
         view_interface.cleanup = view_sdl_cleanup;
         view_interface.render = view_sdl_render;
+        view_interface.present = view_sdl_present;
         view_interface.handle_input = view_sdl_handle_input;
         view_interface.show_pause = view_sdl_show_pause;
         view_interface.show_game_over = view_sdl_show_game_over;
@@ -62,6 +136,18 @@ static bool select_view(ViewType type) {
         return true;
     }
 
+    if (type == VIEW_ANSI) {
+        view_interface.init = view_ansi_init;
+        view_interface.cleanup = view_ansi_cleanup;
+        view_interface.render = view_ansi_render;
+        view_interface.present = view_ansi_present;
+        view_interface.handle_input = view_ansi_handle_input;
+        view_interface.show_pause = view_ansi_show_pause;
+        view_interface.show_game_over = view_ansi_show_game_over;
+        view_interface.show_menu = view_ansi_show_menu;
+        return true;
+    }
+
     return false;
 }
 
@@ -69,7 +155,7 @@ static bool select_view(ViewType type) {
  * Print usage information
  */
 static void print_usage(const char *prog_name) {
-    fprintf(stderr, "Usage: %s [--ncurses|--sdl] [--level N|-L N]\n", prog_name);
+    fprintf(stderr, "Usage: %s [--ncurses|--sdl|--ansi] [--level N|-L N] [--speed K|max] [--tick-rate HZ] [--seed N] [--record FILE|--replay FILE] [--levels FILE|none] [--headless [--frames N] [--games N] [--threads N]] [--stress [--frames N]] [--check-alloc [--frames N]] [--check-sweep [--frames N]] [--profile]\n", prog_name);
     fprintf(stderr, "Options:\n");
 #ifdef USE_NCURSES
     fprintf(stderr, "  --ncurses   Use ncurses text-based interface (default)\n");
@@ -77,63 +163,451 @@ static void print_usage(const char *prog_name) {
 #ifdef USE_SDL
     fprintf(stderr, "  --sdl       Use SDL3 graphical interface\n");
 #endif
+    fprintf(stderr, "  --ansi      Use the text interface without curses (one write per frame)\n");
     fprintf(stderr, "  --level N, -L N  Start at level N (or set START_LEVEL env var)\n");
+    fprintf(stderr, "  --speed K|max    Simulate K frames per rendered frame, or as many as possible\n");
+    fprintf(stderr, "  --tick-rate HZ   Input polls and rendered frames per second (default %d, up to %d)\n",
+            TARGET_FPS, GAME_TICK_RATE_MAX);
+    fprintf(stderr, "  --headless       Run the simulation without a view and report FPS\n");
+    fprintf(stderr, "  --stress         Step one game on growing boards (up to ~500k enemies) and report ns/frame\n");
+    fprintf(stderr, "  --frames N       Frames to simulate per game in headless and stress modes (default %d)\n",
+            HEADLESS_DEFAULT_FRAMES);
+    fprintf(stderr, "  --games N        Independent games stepped per batch in headless mode (default %d)\n",
+            HEADLESS_DEFAULT_GAMES);
+    fprintf(stderr, "  --threads N      Worker threads for headless mode (default 1)\n");
+    fprintf(stderr, "  --seed N         Seed the game for a reproducible run (default: random)\n");
+    fprintf(stderr, "  --record FILE    Record the session (seed and inputs) to FILE\n");
+    fprintf(stderr, "  --replay FILE    Re-simulate a recording without a view and verify its state hashes\n");
+    fprintf(stderr, "  --levels FILE|none  Level pack to play (default %s when built), none for the built-in levels\n",
+            LEVEL_PACK_FILE);
+    fprintf(stderr, "  --bench NAME     Run a micro-benchmark and exit (--bench list to list them)\n");
+    fprintf(stderr, "  --check-alloc    Run --frames bot-driven frames through the game loop, drawn by the terminal\n"
+                    "                   view into a pseudo-terminal, and fail if any frame or draw allocates\n"
+                    "                   (needs LD_PRELOAD=build/alloc_count.so)\n");
+    fprintf(stderr, "  --check-sweep    Run --frames bot-driven frames at projectile speeds 1-%d and fail if a\n"
+                    "                   projectile passes through an enemy, shield or the player\n",
+            SWEEP_CHECK_MAX_SPEED);
+    fprintf(stderr, "  --profile        Time input, simulation, render and present per frame; F toggles\n");
+    fprintf(stderr, "                   the overlay, percentiles are printed on exit\n");
+}
+
+/**
+ * Map the session's level pack. An explicit --levels path must load;
+ * the default pack is optional and a bad one only costs a warning.
+ * Returns false if the requested pack cannot be used
+ */
+static bool load_level_pack(const char *path, bool required) {
+    if (!required && access(path, F_OK) != 0) {
+        return true;  /* no pack built: built-in levels */
+    }
+    
+    level_pack = level_pack_open(path);
+    if (!level_pack && !required) {
+        fprintf(stderr, "Warning: using the built-in levels\n");
+        return true;
+    }
+    return level_pack != NULL;
+}
+
+/**
+ * Checksum of the session's level pack, 0 for the built-in levels
+ */
+static uint32_t level_pack_id(void) {
+    return level_pack ? level_pack->header->checksum : 0;
+}
+
+/**
+ * Create a game for the session: laid out for its level pack when there is one
+ * Returns NULL on error
+ */
+static GameState *session_game_init(uint64_t seed) {
+    return game_init_level_pack(level_pack, seed);
+}
+
+/**
+ * Scripted bot input for headless runs: a cheap per-game LCG picks an action
+ */
+static ActionSet headless_next_action(unsigned int *seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    switch ((*seed >> 16) & 7u) {
+        case 0:
+        case 1:
+            return ACTION_LEFT;
+        case 2:
+        case 3:
+            return ACTION_RIGHT;
+        case 4:
+            return ACTION_SHOOT;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Step one slice of the batch for the whole run; games that end restart at
+ * the start level. Every game owns its generator and action seed, so results do not depend
+ * on how games are split across threads
+ */
+static void *headless_worker(void *arg) {
+    HeadlessSlice *slice = arg;
+    
+    for (int f = 0; f < slice->opts->frames; f++) {
+        for (int i = 0; i < slice->count; i++) {
+            slice->actions[i] = headless_next_action(&slice->action_seeds[i]);
+        }
+        
+        controller_update_batch(slice->states, slice->actions, slice->count);
+        
+        for (int i = 0; i < slice->count; i++) {
+            if (game_is_over(slice->states[i])) {
+                game_reset(slice->states[i]);
+                if (slice->opts->start_level > 1) {
+                    game_set_level(slice->states[i], slice->opts->start_level);
+                }
+                slice->restarts++;
+            }
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Headless batch loop: steps `games` independent games for `frames` frames
+ * as fast as possible on `threads` threads, restarting any game that ends,
+ * then reports throughput
+ */
+static int headless_loop(const HeadlessOptions *opts) {
+    int games = opts->games;
+    int threads = opts->threads < games ? opts->threads : games;
+    GameState **states = calloc((size_t)games, sizeof(GameState *));
+    ActionSet *actions = malloc((size_t)games * sizeof(ActionSet));
+    unsigned int *action_seeds = malloc((size_t)games * sizeof(unsigned int));
+    HeadlessSlice slices[HEADLESS_MAX_THREADS];
+    pthread_t workers[HEADLESS_MAX_THREADS];
+    
+    bool allocated = states && actions && action_seeds;
+    for (int i = 0; allocated && i < games; i++) {
+        states[i] = session_game_init(opts->seed + (uint64_t)i);
+        allocated = states[i] != NULL;
+    }
+    if (!allocated) {
+        fprintf(stderr, "Error: Failed to allocate %d headless games\n", games);
+        for (int i = 0; states && i < games; i++) {
+            game_free(states[i]);
+        }
+        free(states);
+        free(actions);
+        free(action_seeds);
+        return EXIT_FAILURE;
+    }
+    
+    for (int i = 0; i < games; i++) {
+        if (opts->start_level > 1) {
+            game_set_level(states[i], opts->start_level);
+        }
+        action_seeds[i] = (unsigned int)i * 2654435761u + 1u;
+    }
+    
+    /* Contiguous slices, one per thread */
+    for (int t = 0, first = 0; t < threads; t++) {
+        int count = games / threads + (t < games % threads ? 1 : 0);
+        slices[t].opts = opts;
+        slices[t].states = states + first;
+        slices[t].actions = actions + first;
+        slices[t].action_seeds = action_seeds + first;
+        slices[t].count = count;
+        slices[t].restarts = 0;
+        first += count;
+    }
+    
+    unsigned long start_time = utils_time_ms();
+    
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, headless_worker, &slices[t]) != 0) {
+            break;
+        }
+        started = t;
+    }
+    /* Slices whose thread failed to start run on the main thread */
+    headless_worker(&slices[0]);
+    for (int t = started + 1; t < threads; t++) {
+        headless_worker(&slices[t]);
+    }
+    for (int t = 1; t <= started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    
+    unsigned long elapsed_ms = utils_time_ms() - start_time;
+    double seconds = elapsed_ms > 0 ? elapsed_ms / 1000.0 : 0.001;
+    double total_frames = (double)opts->frames * (double)games;
+    
+    unsigned long restarts = 0;
+    long long score_sum = 0;
+    for (int t = 0; t < threads; t++) {
+        restarts += slices[t].restarts;
+    }
+    for (int i = 0; i < games; i++) {
+        score_sum += states[i]->player.score;
+    }
+    
+    printf("headless: %d games x %d frames = %.0f frames in %.3f s on %d thread(s)\n",
+           games, opts->frames, total_frames, seconds, threads);
+    printf("headless: %.0f frames/s (%.1f ns/frame), %lu games restarted\n",
+           total_frames / seconds, seconds * 1e9 / total_frames, restarts);
+    printf("headless: seed %llu, score checksum %lld\n",
+           (unsigned long long)opts->seed, score_sum);
+    
+    for (int i = 0; i < games; i++) {
+        game_free(states[i]);
+    }
+    free(states);
+    free(actions);
+    free(action_seeds);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Replay a recording without a view, as fast as possible, checking every
+ * keyframe hash against the re-simulated state
+ * Returns EXIT_FAILURE on divergence or a damaged file
+ */
+static int replay_loop(const char *path) {
+    ReplayReader *reader = replay_reader_open(path);
+    if (!reader) return EXIT_FAILURE;
+    
+    if (reader->levels_checksum != level_pack_id()) {
+        fprintf(stderr, "replay: recorded with level pack %08x but %08x is loaded (pick it with --levels)\n",
+                (unsigned)reader->levels_checksum, (unsigned)level_pack_id());
+        replay_reader_close(reader);
+        return EXIT_FAILURE;
+    }
+    
+    GameState *state = session_game_init(reader->seed);
+    if (!state) {
+        fprintf(stderr, "Error: Failed to initialize game state\n");
+        replay_reader_close(reader);
+        return EXIT_FAILURE;
+    }
+    if (reader->start_level > 1) {
+        game_set_level(state, reader->start_level);
+    }
+    
+    uint64_t frames = 0;
+    int keyframes = 0;
+    unsigned long events[GAME_EV_COUNT] = {0};
+    uint32_t event_cursor = game_event_cursor(state);
+    int result = EXIT_SUCCESS;
+    unsigned long start_time = utils_time_ms();
+    
+    bool done = false;
+    while (!done) {
+        ReplayStep step = replay_reader_next(reader);
+        switch (step.type) {
+            case REPLAY_STEP_FRAME:
+                controller_update_batch(&state, &step.actions, 1);
+                frames++;
+                for (const GameEvent *ev; (ev = game_event_next(state, &event_cursor)) != NULL; ) {
+                    events[ev->type]++;
+                }
+                break;
+            case REPLAY_STEP_KEYFRAME:
+                keyframes++;
+                if (step.frame != frames || step.hash != game_hash(state)) {
+                    fprintf(stderr, "replay: diverged at frame %llu (keyframe for frame %llu)\n",
+                            (unsigned long long)frames, (unsigned long long)step.frame);
+                    result = EXIT_FAILURE;
+                    done = true;
+                }
+                break;
+            case REPLAY_STEP_END:
+                done = true;
+                break;
+            case REPLAY_STEP_ERROR:
+            default:
+                fprintf(stderr, "replay: %s is truncated or corrupt after frame %llu\n",
+                        path, (unsigned long long)frames);
+                result = EXIT_FAILURE;
+                done = true;
+                break;
+        }
+    }
+    
+    unsigned long elapsed_ms = utils_time_ms() - start_time;
+    double seconds = elapsed_ms > 0 ? elapsed_ms / 1000.0 : 0.001;
+    
+    printf("replay: %llu frames, %d keyframes %s in %.3f s (%.0f frames/s)\n",
+           (unsigned long long)frames, keyframes,
+           result == EXIT_SUCCESS ? "verified" : "checked", seconds, frames / seconds);
+    printf("replay: seed %llu, level %d, score %d\n",
+           (unsigned long long)reader->seed, state->level, state->player.score);
+    printf("replay: %lu shots, %lu enemies killed, %lu shield hits, %lu player hits, %lu enemy shots\n",
+           events[GAME_EV_PLAYER_SHOT], events[GAME_EV_ENEMY_KILLED], events[GAME_EV_SHIELD_HIT],
+           events[GAME_EV_PLAYER_HIT], events[GAME_EV_ENEMY_SHOT]);
+    
+    game_free(state);
+    replay_reader_close(reader);
+    return result;
+}
+
+/**
+ * Find the counter of the preloaded alloc_count.so
+ * Returns false if the shim is not preloaded
+ */
+static bool alloc_watch_find_libc_counter(void) {
+    void *self = dlopen(NULL, RTLD_LAZY);
+    libc_alloc_calls = self ? dlsym(self, ALLOC_COUNT_SYMBOL) : NULL;
+    return libc_alloc_calls != NULL;
+}
+
+/**
+ * Allocations so far: C allocator calls plus arena allocations with the
+ * shim preloaded, counted heap blocks plus arena allocations without it
+ */
+static uint64_t alloc_watch_count(void) {
+    if (!libc_alloc_calls) return arena_alloc_count();
+    
+    AllocStats stats;
+    arena_stats(&stats);
+    return __atomic_load_n(libc_alloc_calls, __ATOMIC_RELAXED) + stats.arena_allocs;
+}
+
+/**
+ * Start accounting allocations from now on
+ */
+static void alloc_watch_start(void) {
+    memset(&alloc_watch, 0, sizeof(alloc_watch));
+    alloc_watch.last = alloc_watch_count();
+}
+
+/**
+ * Allocations since the previous sample
+ */
+static uint64_t alloc_watch_sample(void) {
+    uint64_t now = alloc_watch_count();
+    uint64_t allocs = now - alloc_watch.last;
+    alloc_watch.allocs += allocs;
+    alloc_watch.last = now;
+    return allocs;
+}
+
+/**
+ * Account the allocations of the frame that just ran
+ */
+static void alloc_watch_frame(void) {
+    if (alloc_watch_sample() > 0) alloc_watch.allocating_frames++;
+    alloc_watch.frames++;
+}
+
+/**
+ * Account the allocations of the draw that just ran
+ */
+static void alloc_watch_render(void) {
+    if (alloc_watch_sample() > 0) alloc_watch.allocating_renders++;
+    alloc_watch.renders++;
+}
+
+/**
+ * Simulate up to `ticks` frames for one polled tick of input
+ * Presses apply together on the first frame only, so a key press acts once
+ * at any speed; held directions keep stepping every PLAYER_MOVE_PERIOD
+ * frames. Stops early once the game ends.
+ */
+static void run_ticks(Controller *controller, GameState *game_state, TickInput input,
+                      int ticks, ReplayWriter *recorder) {
+    for (int t = 0; t < ticks && !game_is_over(game_state); t++) {
+        ActionSet actions = controller_frame_actions(controller, input.pressed, input.held);
+        controller_execute_actions(controller, actions);
+        controller_update(controller);
+        replay_writer_frame(recorder, actions, game_state);
+        alloc_watch_frame();
+        input.pressed = 0;
+    }
 }
 
 /**
  * Main game loop
+ * Input is polled once per tick at `tick_rate` Hz on absolute deadlines, and
+ * `speed` frames are simulated per poll (GAME_SPEED_MAX: as many as fit in
+ * one tick). Every simulated frame is appended to `recorder` when it is not
+ * NULL. Each rendered frame is drawn from `scene`, rebuilt once per frame.
  */
-static int game_loop(GameState *game_state, Controller *controller) {
-    unsigned long frame_time_ms = FRAME_TIME_MS;
-    unsigned long last_time = utils_time_ms();
-    unsigned long lag = 0;
+static int game_loop(GameState *game_state, Controller *controller, ReplayWriter *recorder,
+                     Scene *scene, int speed, int tick_rate) {
+    Pacer pacer;
+    utils_pacer_start(&pacer, tick_rate, utils_time_ns());
     
     /* Main loop */
     while (controller_is_running(controller)) {
-        unsigned long current_time = utils_time_ms();
-        unsigned long elapsed = current_time - last_time;
-        last_time = current_time;
-        lag += elapsed;
+        uint64_t frame_start = profile_clock();
+        int due = utils_pacer_due(&pacer, utils_time_ns(), GAME_MAX_CATCHUP_TICKS);
         
-        /* Handle input (multiple times per frame if needed) */
-        while (lag >= frame_time_ms) {
+        if (speed == GAME_SPEED_MAX) {
+            /* Unthrottled: one poll, then simulate until the next render is due */
+            uint64_t t = profile_clock();
+            TickInput input = view_interface.handle_input();
+            t = profile_lap(PROFILE_INPUT, t);
+            if (input.pressed & ACTION_QUIT) {
+                controller_set_running(controller, false);
+            } else {
+                uint64_t deadline = utils_pacer_next(&pacer);
+                do {
+                    run_ticks(controller, game_state, input,
+                              game_state->is_paused ? 1 : GAME_SPEED_MAX_CHUNK, recorder);
+                    input.pressed = 0;
+                } while (!game_state->is_paused && !game_is_over(game_state) &&
+                         utils_time_ns() < deadline);
+                profile_lap(PROFILE_SIM, t);
+            }
+            due = 0;
+        }
+        
+        /* Handle input once per due tick (several after a stall); each poll
+         * drains everything pending, so later catch-up polls see only what
+         * is still held */
+        while (due-- > 0) {
             /* Process input */
-            Command cmd = view_interface.handle_input();
+            uint64_t t = profile_clock();
+            TickInput input = view_interface.handle_input();
+            t = profile_lap(PROFILE_INPUT, t);
             
-            /* Handle pause separately for rendering */
-            if (cmd == CMD_PAUSE) {
-                controller_execute_command(controller, cmd);
-            } else if (cmd == CMD_QUIT) {
+            if (input.pressed & ACTION_QUIT) {
                 controller_set_running(controller, false);
                 break;
-            } else {
-                controller_execute_command(controller, cmd);
             }
             
             /* Update game state */
-            controller_update(controller);
-            
-            lag -= frame_time_ms;
+            run_ticks(controller, game_state, input, speed, recorder);
+            profile_lap(PROFILE_SIM, t);
         }
         
         /* Render current state */
+        uint64_t t = profile_clock();
+        scene_build(scene, game_state);
+        view_interface.render(game_state, scene);
+        t = profile_lap(PROFILE_RENDER, t);
         if (game_state->is_paused) {
-            view_interface.render(game_state);
             view_interface.show_pause();
         } else {
-            view_interface.render(game_state);
+            view_interface.present();
         }
+        profile_lap(PROFILE_PRESENT, t);
+        profile_lap(PROFILE_FRAME, frame_start);
+        profile_frame_end();
+        alloc_watch_render();
         
         /* Check game over */
         if (game_is_over(game_state)) {
-            view_interface.render(game_state);
+            scene_build(scene, game_state);
+            view_interface.render(game_state, scene);
             view_interface.show_game_over(game_state);
             
             /* Wait for quit */
             bool wait_quit = true;
             while (wait_quit) {
-                Command cmd = view_interface.handle_input();
-                if (cmd == CMD_QUIT) {
+                TickInput input = view_interface.handle_input();
+                if (input.pressed & ACTION_QUIT) {
                     wait_quit = false;
                     controller_set_running(controller, false);
                 }
@@ -141,19 +615,364 @@ static int game_loop(GameState *game_state, Controller *controller) {
             }
         }
         
-        /* Small sleep to prevent busy-waiting */
-        utils_sleep_ms(5);
+        /* Sleep to the next tick's deadline (turbo keeps the CPU busy) */
+        if (speed != GAME_SPEED_MAX || game_state->is_paused) {
+            utils_sleep_until_ns(utils_pacer_next(&pacer));
+        }
     }
     
     return EXIT_SUCCESS;
 }
 
+/* Scripted input and screens for --check-alloc: bot input, and the pause,
+ * game over and menu screens skipped; the selected terminal view draws
+ * every frame. It quits once the frame budget is spent or the game ends. */
+static unsigned int check_view_seed;
+static unsigned long check_view_budget;
+static bool check_view_done;
+
+static TickInput check_view_handle_input(void) {
+    if (check_view_done || alloc_watch.frames >= check_view_budget) {
+        return (TickInput){ACTION_QUIT, 0};
+    }
+    return (TickInput){headless_next_action(&check_view_seed), 0};
+}
+
+static void check_view_show_pause(void) {
+}
+
+static void check_view_show_game_over(const GameState *state) {
+    (void)state;
+    check_view_done = true;
+}
+
+static Command check_view_show_menu(void) {
+    return CMD_NONE;
+}
+
+/* Pseudo-terminal a terminal view draws into during --check-alloc: stdin
+ * and stdout point at its slave side while the check runs, and a thread
+ * drains the master side so the view never blocks on a full terminal */
+typedef struct {
+    int master;
+    int saved_stdin, saved_stdout;
+    int stopping;
+    pthread_t drain;
+} CheckTerminal;
+
+/**
+ * Drain thread: discard whatever the view writes until asked to stop
+ */
+static void *check_terminal_drain(void *arg) {
+    CheckTerminal *term = arg;
+    static char buf[65536];
+    struct pollfd pfd = {.fd = term->master, .events = POLLIN};
+    
+    while (!__atomic_load_n(&term->stopping, __ATOMIC_ACQUIRE)) {
+        if (poll(&pfd, 1, 50) > 0 && read(term->master, buf, sizeof(buf)) < 0 && errno != EINTR) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Put stdin and stdout on a fresh pseudo-terminal large enough for the
+ * board of `config`
+ * Returns false if no pseudo-terminal could be set up
+ */
+static bool check_terminal_open(CheckTerminal *term, const GameConfig *config) {
+    struct winsize size = {
+        .ws_row = (unsigned short)(config->board_height + 3 > MIN_TERM_HEIGHT ?
+                                   config->board_height + 3 : MIN_TERM_HEIGHT),
+        .ws_col = (unsigned short)(config->board_width + 3 > MIN_TERM_WIDTH ?
+                                   config->board_width + 3 : MIN_TERM_WIDTH),
+    };
+    int slave;
+    if (openpty(&term->master, &slave, NULL, NULL, &size) != 0) return false;
+    
+    fflush(stdout);
+    term->saved_stdin = dup(STDIN_FILENO);
+    term->saved_stdout = dup(STDOUT_FILENO);
+    dup2(slave, STDIN_FILENO);
+    dup2(slave, STDOUT_FILENO);
+    close(slave);
+    setenv("TERM", "xterm-256color", 0);
+    
+    term->stopping = 0;
+    if (pthread_create(&term->drain, NULL, check_terminal_drain, term) != 0) {
+        dup2(term->saved_stdin, STDIN_FILENO);
+        dup2(term->saved_stdout, STDOUT_FILENO);
+        close(term->saved_stdin);
+        close(term->saved_stdout);
+        close(term->master);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Give stdin and stdout back and close the pseudo-terminal
+ */
+static void check_terminal_close(CheckTerminal *term) {
+    fflush(stdout);
+    dup2(term->saved_stdin, STDIN_FILENO);
+    dup2(term->saved_stdout, STDOUT_FILENO);
+    close(term->saved_stdin);
+    close(term->saved_stdout);
+    
+    __atomic_store_n(&term->stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(term->drain, NULL);
+    close(term->master);
+}
+
+/**
+ * One game of the allocation check through game_loop, then a fresh game
+ */
+static void alloc_check_game(GameState *game_state, Controller *controller,
+                             ReplayWriter *recorder, Scene *scene) {
+    check_view_done = false;
+    controller_set_running(controller, true);
+    game_loop(game_state, controller, recorder, scene, 1, ALLOC_CHECK_TICK_RATE);
+    game_reset(game_state);
+}
+
+/**
+ * Allocation check: a full session (arena-backed game and controller,
+ * recorder, event log, the selected terminal view drawing into a
+ * pseudo-terminal) driven through game_loop by scripted input, restarting
+ * games until `frames` frames ran
+ * The SDL view is not checked: SDL's offscreen driver and the GL driver
+ * under it allocate inside every present.
+ * Returns EXIT_FAILURE if any simulated frame or draw allocated
+ */
+static int alloc_check_loop(int frames, uint64_t seed, ViewType view_type) {
+    if (view_type == VIEW_SDL || !select_view(view_type)) {
+        fprintf(stderr, "Error: --check-alloc draws with a terminal view (--ncurses or --ansi)\n");
+        return EXIT_FAILURE;
+    }
+    if (!alloc_watch_find_libc_counter()) {
+        fprintf(stderr, "Error: --check-alloc counts C allocator calls with build/alloc_count.so: "
+                        "run it under LD_PRELOAD=build/alloc_count.so, or use make check-alloc\n");
+        return EXIT_FAILURE;
+    }
+    view_interface.handle_input = check_view_handle_input;
+    view_interface.show_pause = check_view_show_pause;
+    view_interface.show_game_over = check_view_show_game_over;
+    view_interface.show_menu = check_view_show_menu;
+    check_view_seed = (unsigned int)seed | 1u;
+    check_view_budget = (unsigned long)frames;
+    
+    AllocStats start, setup;
+    uint64_t libc_start = __atomic_load_n(libc_alloc_calls, __ATOMIC_RELAXED);
+    arena_stats(&start);
+    
+    GameState *game_state = session_game_init(seed);
+    Controller *controller = game_state ? controller_init(game_state) : NULL;
+    Scene *scene = game_state ? scene_create(&game_state->config) : NULL;
+    ReplayWriter *recorder = replay_writer_open("/dev/null", seed, 1, level_pack_id());
+    if (!controller || !scene || !recorder || !log_init("/dev/null")) {
+        fprintf(stderr, "Error: Failed to set up the allocation check\n");
+        replay_writer_close(recorder);
+        scene_free(scene);
+        controller_free(controller);
+        game_free(game_state);
+        return EXIT_FAILURE;
+    }
+    
+    CheckTerminal term;
+    if (!check_terminal_open(&term, &game_state->config)) {
+        fprintf(stderr, "Error: No pseudo-terminal for the allocation check\n");
+        log_shutdown();
+        replay_writer_close(recorder);
+        scene_free(scene);
+        controller_free(controller);
+        game_free(game_state);
+        return EXIT_FAILURE;
+    }
+    bool view_ready = view_interface.init(&game_state->config);
+    uint64_t libc_setup = __atomic_load_n(libc_alloc_calls, __ATOMIC_RELAXED);
+    arena_stats(&setup);
+    
+    int games = 0;
+    if (view_ready) {
+        /* One unwatched game first: it fills the one-time caches of the view
+         * and the libraries under it (ncurses parses each terminal
+         * capability and sets up its scroll hash on first use) */
+        alloc_watch_start();
+        alloc_check_game(game_state, controller, recorder, scene);
+        
+        alloc_watch_start();
+        while (alloc_watch.frames < check_view_budget) {
+            alloc_check_game(game_state, controller, recorder, scene);
+            games++;
+        }
+        view_interface.cleanup();
+    }
+    check_terminal_close(&term);
+    
+    log_shutdown();
+    replay_writer_close(recorder);
+    scene_free(scene);
+    controller_free(controller);
+    game_free(game_state);
+    
+    if (!view_ready) {
+        fprintf(stderr, "Error: Failed to initialize view\n");
+        return EXIT_FAILURE;
+    }
+    
+    printf("alloc: setup took %llu C allocator calls, %llu of them heap blocks (%.1f KiB), "
+           "and %llu arena allocations (%.1f KiB)\n",
+           (unsigned long long)(libc_setup - libc_start),
+           (unsigned long long)(setup.heap_allocs - start.heap_allocs),
+           (setup.heap_bytes - start.heap_bytes) / 1024.0,
+           (unsigned long long)(setup.arena_allocs - start.arena_allocs),
+           (setup.arena_bytes - start.arena_bytes) / 1024.0);
+    printf("alloc: %lu frames and %lu draws in %d games through game_loop after a warm-up game, "
+           "%lu frames and %lu draws allocated (%llu allocations)\n",
+           alloc_watch.frames, alloc_watch.renders, games, alloc_watch.allocating_frames,
+           alloc_watch.allocating_renders, (unsigned long long)alloc_watch.allocs);
+    if (profile_active) {
+        profile_summary(stdout);
+    }
+    return alloc_watch.allocating_frames == 0 && alloc_watch.allocating_renders == 0 ?
+           EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Whether cell (x, y) is covered by a live enemy
+ */
+static bool sweep_enemy_at(const GameState *state, int x, int y) {
+    for (int j = game_next_enemy(state, 0); j >= 0; j = game_next_enemy(state, j + 1)) {
+        int ex = game_enemy_x(state, j), ey = game_enemy_y(state, j);
+        if (x >= ex && x < ex + ENEMY_WIDTH && y >= ey && y < ey + ENEMY_HEIGHT) return true;
+    }
+    return false;
+}
+
+/**
+ * Whether cell (x, y) is a shield cell with hits left
+ */
+static bool sweep_shield_at(const GameState *state, int x, int y) {
+    for (int s = 0; s < state->config.shield_count; s++) {
+        const Shield *shield = &state->shields[s];
+        int c = x - shield->x, r = y - shield->y;
+        if (c >= 0 && c < SHIELD_WIDTH && r >= 0 && r < SHIELD_HEIGHT &&
+            game_shield_cell_health(shield, c * SHIELD_COLUMN_BITS + r) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Whether a projectile that survived the frame crossed an occupied cell: its
+ * swept segment is the `speed` cells it entered this frame, ending at its
+ * position. Collisions only clear cells, so a cell still occupied after the
+ * frame was occupied when the projectile passed it.
+ */
+static bool sweep_tunneled(const GameState *state, const Projectile *proj, int speed, bool player_shot) {
+    int y_lo = player_shot ? proj->y : proj->y - speed + 1;
+    int y_hi = player_shot ? proj->y + speed - 1 : proj->y;
+    if (y_lo < 0) y_lo = 0;
+    if (y_hi > state->config.board_height - 1) y_hi = state->config.board_height - 1;
+    
+    for (int y = y_lo; y <= y_hi; y++) {
+        if (sweep_shield_at(state, proj->x, y)) return true;
+        if (player_shot && sweep_enemy_at(state, proj->x, y)) return true;
+        if (!player_shot && proj->x >= state->player.x && proj->x < state->player.x + PLAYER_WIDTH &&
+            y >= state->player.y && y < state->player.y + PLAYER_HEIGHT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Sweep check: bot-driven games stepped `frames` frames at every projectile
+ * speed from 1 to SWEEP_CHECK_MAX_SPEED cells per frame (both sides),
+ * restarting games that end, checking every surviving projectile after
+ * every frame
+ * Returns EXIT_FAILURE if any projectile passed through an enemy, a shield
+ * or the player
+ */
+static int sweep_check_loop(int frames, uint64_t seed) {
+    GameState *state = session_game_init(seed);
+    if (!state) {
+        fprintf(stderr, "Error: Failed to initialize game state\n");
+        return EXIT_FAILURE;
+    }
+    
+    unsigned long tunneled = 0;
+    for (int speed = 1; speed <= SWEEP_CHECK_MAX_SPEED; speed++) {
+        unsigned int action_seed = (unsigned int)seed * 2654435761u + (unsigned int)speed;
+        unsigned long checked = 0, failures = 0;
+        unsigned long events[GAME_EV_COUNT] = {0};
+        int games = 1;
+        
+        game_reset_seeded(state, seed + (uint64_t)speed);
+        uint32_t cursor = game_event_cursor(state);
+        for (int f = 0; f < frames; f++) {
+            /* Resets and level changes restore the default speeds */
+            state->projectile_speed = speed;
+            state->enemy_projectile_speed = speed;
+            
+            ActionSet action = headless_next_action(&action_seed);
+            controller_update_batch(&state, &action, 1);
+            for (const GameEvent *ev; (ev = game_event_next(state, &cursor)) != NULL; ) {
+                events[ev->type]++;
+            }
+            
+            for (int i = 0; i < state->projectile_count; i++) {
+                failures += sweep_tunneled(state, &state->projectiles[i], speed, true);
+            }
+            for (int i = 0; i < state->enemy_projectile_count; i++) {
+                failures += sweep_tunneled(state, &state->enemy_projectiles[i], speed, false);
+            }
+            checked += (unsigned long)(state->projectile_count + state->enemy_projectile_count);
+            
+            if (game_is_over(state)) {
+                game_reset(state);
+                games++;
+            }
+        }
+        
+        printf("sweep: speed %2d: %d frames in %d games, %lu shots, %lu kills, %lu shield hits, "
+               "%lu player hits, %lu in flight checked, %lu tunneled\n",
+               speed, frames, games, events[GAME_EV_PLAYER_SHOT] + events[GAME_EV_ENEMY_SHOT],
+               events[GAME_EV_ENEMY_KILLED], events[GAME_EV_SHIELD_HIT], events[GAME_EV_PLAYER_HIT],
+               checked, failures);
+        tunneled += failures;
+    }
+    
+    game_free(state);
+    return tunneled == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 /**
  * Main entry point
  */
 int main(int argc, char *argv[]) {
     ViewType view_type = VIEW_NCURSES;  /* Default */
     int start_level_arg = 1; /* default start level (can be overridden by CLI or env) */
+    bool headless = false;
+    bool stress = false;
+    bool check_alloc = false;
+    bool check_sweep = false;
+    HeadlessOptions headless_opts = {
+        .frames = HEADLESS_DEFAULT_FRAMES,
+        .games = HEADLESS_DEFAULT_GAMES,
+        .threads = 1,
+    };
+    bool seed_given = false;
+    uint64_t seed = 0;
+    int speed = 1;
+    int tick_rate = TARGET_FPS;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    const char *levels_path = LEVEL_PACK_FILE;
+    bool levels_given = false;
     
     /* Parse command line arguments */
     for (int i = 1; i < argc; i++) {
@@ -161,6 +980,8 @@ int main(int argc, char *argv[]) {
             view_type = VIEW_NCURSES;
         } else if (strcmp(argv[i], "--sdl") == 0) {
             view_type = VIEW_SDL;
+        } else if (strcmp(argv[i], "--ansi") == 0) {
+            view_type = VIEW_ANSI;
         } else if (strcmp(argv[i], "--level") == 0 || strcmp(argv[i], "-L") == 0) {
             /* Read next argument as the desired start level */
             if (i + 1 < argc) {
@@ -172,6 +993,90 @@ int main(int argc, char *argv[]) {
                 print_usage(argv[0]);
                 return EXIT_FAILURE;
             }
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            stress = true;
+        } else if (strcmp(argv[i], "--check-alloc") == 0) {
+            check_alloc = true;
+        } else if (strcmp(argv[i], "--check-sweep") == 0) {
+            check_sweep = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile_enable();
+        } else if (strcmp(argv[i], "--frames") == 0 || strcmp(argv[i], "--games") == 0 ||
+                   strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 < argc && atoi(argv[i+1]) > 0) {
+                int v = atoi(argv[i+1]);
+                if (strcmp(argv[i], "--frames") == 0) headless_opts.frames = v;
+                else if (strcmp(argv[i], "--games") == 0) headless_opts.games = v;
+                else headless_opts.threads = v < HEADLESS_MAX_THREADS ? v : HEADLESS_MAX_THREADS;
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing or invalid value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            if (i + 1 < argc) {
+                seed = strtoull(argv[i+1], NULL, 0);
+                seed_given = true;
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--speed") == 0) {
+            if (i + 1 < argc && (strcmp(argv[i+1], "max") == 0 || atoi(argv[i+1]) > 0)) {
+                int v = strcmp(argv[i+1], "max") == 0 ? GAME_SPEED_MAX : atoi(argv[i+1]);
+                speed = v < GAME_SPEED_LIMIT ? v : GAME_SPEED_LIMIT;
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing or invalid value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--tick-rate") == 0) {
+            if (i + 1 < argc && atoi(argv[i+1]) > 0) {
+                int v = atoi(argv[i+1]);
+                tick_rate = v < GAME_TICK_RATE_MAX ? v : GAME_TICK_RATE_MAX;
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing or invalid value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--record") == 0 || strcmp(argv[i], "--replay") == 0) {
+            if (i + 1 < argc) {
+                if (strcmp(argv[i], "--record") == 0) record_path = argv[i+1];
+                else replay_path = argv[i+1];
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--levels") == 0) {
+            if (i + 1 < argc) {
+                levels_path = strcmp(argv[i+1], "none") == 0 ? NULL : argv[i+1];
+                levels_given = true;
+                i++; /* skip value */
+            } else {
+                fprintf(stderr, "Missing value for %s\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            if (i + 1 < argc) {
+                if (strcmp(argv[i+1], "list") == 0) {
+                    bench_list(stdout);
+                    return EXIT_SUCCESS;
+                }
+                return bench_run(argv[i+1]);
+            }
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            bench_list(stderr);
+            return EXIT_FAILURE;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -182,8 +1087,53 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    /* Initialize utilities */
-    utils_random_seed();
+    /* Level layouts, mapped once for the whole session */
+    if (levels_path && !load_level_pack(levels_path, levels_given)) {
+        return EXIT_FAILURE;
+    }
+    
+    /* Replay: seed and start level come from the recording */
+    if (replay_path) {
+        int result = replay_loop(replay_path);
+        level_pack_close(level_pack);
+        return result;
+    }
+    
+    /* Pick the session seed */
+    if (!seed_given) {
+        seed = utils_entropy_seed();
+    }
+    
+    /* Steady-state allocation check of the interactive loop */
+    if (check_alloc) {
+        int result = alloc_check_loop(headless_opts.frames, seed, view_type);
+        level_pack_close(level_pack);
+        return result;
+    }
+    
+    /* Projectile sweep check at every speed up to SWEEP_CHECK_MAX_SPEED */
+    if (check_sweep) {
+        int result = sweep_check_loop(headless_opts.frames, seed);
+        level_pack_close(level_pack);
+        return result;
+    }
+    
+    /* Scaling sweep over runtime board sizes (built-in levels) */
+    if (stress) {
+        level_pack_close(level_pack);
+        return bench_stress(headless_opts.frames, seed);
+    }
+    
+    /* Headless batch simulation: no view, no menu, no score file */
+    if (headless) {
+        char *env_lvl = getenv("START_LEVEL");
+        if (env_lvl && atoi(env_lvl) > 0) start_level_arg = atoi(env_lvl);
+        headless_opts.start_level = start_level_arg;
+        headless_opts.seed = seed;
+        int result = headless_loop(&headless_opts);
+        level_pack_close(level_pack);
+        return result;
+    }
     
     /* Select view */
     if (!select_view(view_type)) {
@@ -191,17 +1141,17 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
     
-    /* Initialize view */
-    if (!view_interface.init()) {
-        fprintf(stderr, "Error: Failed to initialize view\n");
-        return EXIT_FAILURE;
-    }
-    
     /* Initialize model */
-    GameState *game_state = game_init();
+    GameState *game_state = session_game_init(seed);
     if (!game_state) {
         fprintf(stderr, "Error: Failed to initialize game state\n");
-        view_interface.cleanup();
+        return EXIT_FAILURE;
+    }
+    
+    /* Initialize view, sized for the board the level pack asks for */
+    if (!view_interface.init(&game_state->config)) {
+        fprintf(stderr, "Error: Failed to initialize view\n");
+        game_free(game_state);
         return EXIT_FAILURE;
     }
 
@@ -212,13 +1162,6 @@ int main(int argc, char *argv[]) {
         if (v > 0) start_level_arg = v;
     }
 
-    /* Advance game to the requested start level (1-based) */
-    if (start_level_arg > 1) {
-        for (int lv = 1; lv < start_level_arg; lv++) {
-            game_next_level(game_state);
-        }
-    }
-    
     /* Initialize controller */
     Controller *controller = controller_init(game_state);
     if (!controller) {
@@ -228,6 +1171,16 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
     
+    /* Draw list the view renders from */
+    Scene *scene = scene_create(&game_state->config);
+    if (!scene) {
+        fprintf(stderr, "Error: Failed to initialize scene\n");
+        controller_free(controller);
+        game_free(game_state);
+        view_interface.cleanup();
+        return EXIT_FAILURE;
+    }
+    
     /* Set initial UI level in the view (so the menu shows the desired start level) */
     #ifdef USE_NCURSES
     if (view_type == VIEW_NCURSES) view_ncurses_set_ui_level(start_level_arg);
@@ -235,10 +1188,12 @@ int main(int argc, char *argv[]) {
     #ifdef USE_SDL
     if (view_type == VIEW_SDL) view_sdl_set_ui_level(start_level_arg);
     #endif
+    if (view_type == VIEW_ANSI) view_ansi_set_ui_level(start_level_arg);
 
     /* Show menu and apply UI-selected level */
     Command menu_cmd = view_interface.show_menu();
     if (menu_cmd == CMD_QUIT) {
+        scene_free(scene);
         controller_free(controller);
         game_free(game_state);
         view_interface.cleanup();
@@ -252,13 +1207,32 @@ int main(int argc, char *argv[]) {
     #ifdef USE_SDL
     if (view_type == VIEW_SDL) ui_selected_level = view_sdl_get_ui_level();
     #endif
+    if (view_type == VIEW_ANSI) ui_selected_level = view_ansi_get_ui_level();
 
+    /* Seek straight to the selected level (1-based) */
     if (ui_selected_level > 1) {
         game_set_level(game_state, ui_selected_level);
     }
     
+    /* Record from the first simulated frame */
+    ReplayWriter *recorder = NULL;
+    if (record_path) {
+        recorder = replay_writer_open(record_path, seed, ui_selected_level, level_pack_id());
+        if (recorder) {
+            replay_writer_keyframe(recorder, game_state);
+        } else {
+            fprintf(stderr, "Warning: cannot record to %s\n", record_path);
+        }
+    }
+    
+    /* Game events go to the log file off the simulation thread */
+    log_init(LOG_FILE);
+    
     /* Run game loop */
-    int result = game_loop(game_state, controller);
+    alloc_watch_start();
+    int result = game_loop(game_state, controller, recorder, scene, speed, tick_rate);
+    replay_writer_close(recorder);
+    log_shutdown();
     
     /* Save score */
     if (game_state->player.score > 0) {
@@ -266,9 +1240,22 @@ int main(int argc, char *argv[]) {
     }
     
     /* Cleanup */
+    scene_free(scene);
     controller_free(controller);
     game_free(game_state);
     view_interface.cleanup();
+    level_pack_close(level_pack);
+    
+    /* Frame timing summary, once the terminal is back */
+    if (profile_active) {
+        profile_summary(stderr);
+    }
+    
+    if (alloc_watch.allocating_frames > 0) {
+        fprintf(stderr, "Warning: %lu of %lu frames allocated memory (%llu allocations)\n",
+                alloc_watch.allocating_frames, alloc_watch.frames,
+                (unsigned long long)alloc_watch.allocs);
+    }
     
     return result;
 }
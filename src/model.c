@@ -6,37 +6,233 @@
 #include "model.h"
 #include "config.h"
 #include "utils.h"
+#include "log.h"
+#include "arena.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 /* Internal helper functions */
+static size_t layout_state(GameState *state, const GameConfig *config);
+static bool config_valid(const GameConfig *config, const LevelPack *pack);
+static GameState *game_create(const GameConfig *config, const LevelPack *pack, uint64_t seed);
+static void init_level(GameState *state);
 static void init_enemies(GameState *state);
 static void init_shields(GameState *state);
+static void load_level(GameState *state, const LevelRecord *record);
+static void place_formation(GameState *state, int origin_x, int origin_y);
+static int pick_shooter(GameState *state);
 static void update_enemies(GameState *state);
 static void update_projectiles(GameState *state);
 static void update_enemy_projectiles(GameState *state);
 static void handle_collisions(GameState *state);
 static void check_level_complete(GameState *state);
+static void grid_stamp_enemy(GameState *state, int j, bool covered);
+static void kill_enemy(GameState *state, int j);
+static int enemy_move_period(const GameState *state);
+static void grid_stamp_shield_columns(GameState *state, int x_from, int x_to);
+static inline int grid_first_hit(const GridLayer *layer, int x, int lo, int hi, bool up);
+static int grid_first_hit_words(const uint64_t *col, int w_lo, int w_hi,
+                                uint64_t lo_mask, uint64_t hi_mask, bool up);
+static void hit_shields(GameState *state, int x, int y);
+static void push_event(GameState *state, GameEventType type, int x, int y, int value);
+
+/* Live-cell mask of a fresh shield: SHIELD_HEIGHT low bits in each of the
+ * SHIELD_WIDTH columns */
+#define SHIELD_COLUMN_FULL ((1ULL << SHIELD_HEIGHT) - 1)
+#define SHIELD_FULL_MASK (SHIELD_COLUMN_FULL * (0x0101010101010101ULL >> (SHIELD_COLUMN_BITS * (8 - SHIELD_WIDTH))))
+
+/* A shield's cells fit one 64-bit mask, a column per byte */
+typedef char shield_fits_a_mask[
+    SHIELD_WIDTH <= 8 && SHIELD_HEIGHT <= SHIELD_COLUMN_BITS && SHIELD_COLUMN_BITS == 8 ? 1 : -1];
+
+/* The event ring wraps by masking its head */
+typedef char game_event_capacity_is_a_power_of_two[
+    (GAME_EVENT_CAPACITY & (GAME_EVENT_CAPACITY - 1)) == 0 ? 1 : -1];
+
+/* Alignment of each array inside the state block (arena allocations are
+ * aligned to the same cache line) */
+#define STATE_ALIGN ARENA_ALIGN
+
+/**
+ * Fill in the default configuration
+ */
+void game_config_default(GameConfig *config)
+{
+    if (!config)
+        return;
+
+    config->board_width = BOARD_WIDTH;
+    config->board_height = BOARD_HEIGHT;
+    config->enemy_count = INITIAL_ENEMIES;
+    config->enemy_cols = ENEMY_COLS;
+    config->enemy_spacing_x = ENEMY_SPACING_X;
+    config->enemy_spacing_y = ENEMY_SPACING_Y;
+    config->max_projectiles = MAX_PROJECTILES;
+    config->max_enemy_projectiles = MAX_ENEMY_PROJECTILES;
+    config->shield_count = SHIELD_COUNT;
+}
+
+/**
+ * A config is playable when the formation fits inside the board with room
+ * to move, and coordinates stay within the 16-bit event fields. With a
+ * pack, each level places the formation at its own origin, and
+ * level_pack_open has checked those fit; otherwise it starts at
+ * ENEMY_START_X/Y.
+ */
+static bool config_valid(const GameConfig *config, const LevelPack *pack)
+{
+    if (config->board_width < PLAYER_WIDTH || config->board_width < SHIELD_WIDTH ||
+        config->board_height < PLAYER_HEIGHT + 2 ||
+        config->board_width > INT16_MAX || config->board_height > INT16_MAX)
+        return false;
+    if (config->enemy_count < 1 || config->enemy_cols < 1 ||
+        config->enemy_spacing_x < ENEMY_WIDTH || config->enemy_spacing_y < ENEMY_HEIGHT)
+        return false;
+    if (config->max_projectiles < 0 || config->max_enemy_projectiles < 0 ||
+        config->shield_count < 0)
+        return false;
+    if (pack)
+        return true;
+
+    int cols = config->enemy_cols < config->enemy_count ? config->enemy_cols : config->enemy_count;
+    int rows = (config->enemy_count + config->enemy_cols - 1) / config->enemy_cols;
+    long right = ENEMY_START_X + (long)(cols - 1) * config->enemy_spacing_x + ENEMY_WIDTH;
+    long bottom = ENEMY_START_Y + (long)(rows - 1) * config->enemy_spacing_y;
+    return right < config->board_width && bottom < config->board_height - 2;
+}
+
+/**
+ * Reserve `bytes` at the next aligned offset of a state block
+ */
+static size_t take(size_t *offset, size_t bytes)
+{
+    size_t at = (*offset + STATE_ALIGN - 1) & ~(size_t)(STATE_ALIGN - 1);
+    *offset = at + bytes;
+    return at;
+}
+
+/**
+ * Lay out the arrays for `config` behind the header and point `state` at
+ * them (state may be NULL to only measure). Offsets depend on the config
+ * alone, so a block copied from another state is rebased by running this
+ * again. Returns the block size.
+ */
+static size_t layout_state(GameState *state, const GameConfig *config)
+{
+    int cols = config->enemy_cols;
+    int rows = (config->enemy_count + cols - 1) / cols;
+    int enemy_words = (config->enemy_count + 63) / 64;
+    int enemy_width = (cols - 1) * config->enemy_spacing_x + ENEMY_WIDTH;
+    int enemy_height = (rows - 1) * config->enemy_spacing_y + ENEMY_HEIGHT;
+    int enemy_grid_words = (enemy_height + 63) / 64;
+    int shield_grid_words = (config->board_height + 63) / 64;
+
+    size_t offset = sizeof(GameState);
+    size_t alive_at = take(&offset, (size_t)enemy_words * sizeof(uint64_t));
+    size_t col_alive_at = take(&offset, (size_t)cols * sizeof(int));
+    size_t row_alive_at = take(&offset, (size_t)rows * sizeof(int));
+    size_t col_bottom_at = take(&offset, (size_t)cols * sizeof(int));
+    size_t live_cols_at = take(&offset, (size_t)cols * sizeof(int));
+    size_t live_col_pos_at = take(&offset, (size_t)cols * sizeof(int));
+    size_t shots_at = take(&offset, (size_t)config->max_projectiles * sizeof(Projectile));
+    size_t enemy_shots_at = take(&offset, (size_t)config->max_enemy_projectiles * sizeof(Projectile));
+    size_t shields_at = take(&offset, (size_t)config->shield_count * sizeof(Shield));
+    size_t enemy_grid_at = take(&offset, (size_t)enemy_width * enemy_grid_words * sizeof(uint64_t));
+    size_t shield_grid_at = take(&offset, (size_t)config->board_width * shield_grid_words * sizeof(uint64_t));
+    size_t size = take(&offset, 0);
+
+    if (state)
+    {
+        unsigned char *base = (unsigned char *)state;
+        state->size = size;
+        state->enemy_words = enemy_words;
+        state->enemy_alive = (uint64_t *)(base + alive_at);
+        state->formation.rows = rows;
+        state->formation.cols = cols;
+        state->formation.col_alive = (int *)(base + col_alive_at);
+        state->formation.row_alive = (int *)(base + row_alive_at);
+        state->formation.col_bottom = (int *)(base + col_bottom_at);
+        state->formation.live_cols = (int *)(base + live_cols_at);
+        state->formation.live_col_pos = (int *)(base + live_col_pos_at);
+        state->projectiles = (Projectile *)(base + shots_at);
+        state->enemy_projectiles = (Projectile *)(base + enemy_shots_at);
+        state->shields = (Shield *)(base + shields_at);
+        state->grid.enemy = (GridLayer){(uint64_t *)(base + enemy_grid_at),
+                                        enemy_width, enemy_height, enemy_grid_words};
+        state->grid.shield = (GridLayer){(uint64_t *)(base + shield_grid_at),
+                                         config->board_width, config->board_height,
+                                         shield_grid_words};
+    }
+    return size;
+}
 
 /**
  * Initialize game state
  */
 GameState *game_init(void)
 {
-    GameState *state = malloc(sizeof(GameState));
-    if (!state)
+    return game_init_seeded(utils_entropy_seed());
+}
+
+/**
+ * Initialize game state from a seed
+ */
+GameState *game_init_seeded(uint64_t seed)
+{
+    GameConfig config;
+    game_config_default(&config);
+    return game_init_ex(&config, seed);
+}
+
+/**
+ * Initialize game state with a runtime configuration
+ */
+GameState *game_init_ex(const GameConfig *config, uint64_t seed)
+{
+    return game_create(config, NULL, seed);
+}
+
+/**
+ * Initialize game state laid out for a level pack
+ */
+GameState *game_init_level_pack(const LevelPack *pack, uint64_t seed)
+{
+    GameConfig config;
+    game_config_level_pack(&config, pack);
+    return game_create(&config, pack, seed);
+}
+
+/**
+ * Create a game for `config` playing the levels of `pack` (NULL: built-in)
+ */
+static GameState *game_create(const GameConfig *config, const LevelPack *pack, uint64_t seed)
+{
+    if (!config || !config_valid(config, pack))
         return NULL;
 
-    memset(state, 0, sizeof(GameState));
+    /* The session arena: the state block, then the controller and per-game data */
+    size_t size = layout_state(NULL, config);
+    Arena *arena = arena_create(size + GAME_ARENA_HEADROOM);
+    if (!arena)
+        return NULL;
+
+    GameState *state = arena_alloc(arena, size);
+    memset(state, 0, size);
+    arena_keep(arena);
+    state->arena = arena;
+    state->config = *config;
+    layout_state(state, config);
+    utils_rng_seed(&state->rng, seed);
 
     /* Initialize player */
-    state->player.x = BOARD_WIDTH / 2 - PLAYER_WIDTH / 2;
-    state->player.y = BOARD_HEIGHT - 2;
+    state->player.x = config->board_width / 2 - PLAYER_WIDTH / 2;
+    state->player.y = config->board_height - 2;
     state->player.health = INITIAL_LIVES;
     state->player.score = 0;
 
     state->level = INITIAL_LEVEL;
+    state->projectile_speed = PROJECTILE_SPEED;
     state->enemy_direction = 1; /* Move right initially */
     state->enemy_move_counter = 0;
     state->enemy_fire_timer = 0;
@@ -44,13 +240,85 @@ GameState *game_init(void)
     state->is_paused = false;
     state->game_over = false;
     state->player_won = false;
+    state->levels = pack;
 
-    init_enemies(state);
-    init_shields(state);
+    init_level(state);
 
     return state;
 }
 
+/**
+ * Default capacities, board and formation from the pack
+ */
+void game_config_level_pack(GameConfig *config, const LevelPack *pack)
+{
+    if (!config)
+        return;
+
+    game_config_default(config);
+    if (!pack)
+        return;
+
+    const LevelPackHeader *h = pack->header;
+    config->board_width = h->board_width;
+    config->board_height = h->board_height;
+    config->enemy_count = (int)h->enemy_count;
+    config->enemy_cols = h->enemy_cols;
+    config->enemy_spacing_x = h->enemy_spacing_x;
+    config->enemy_spacing_y = h->enemy_spacing_y;
+    config->shield_count = h->shield_count;
+}
+
+/**
+ * Switch level layouts and lay out the current level again
+ */
+bool game_use_level_pack(GameState *state, const LevelPack *pack)
+{
+    if (!state)
+        return false;
+
+    if (pack)
+    {
+        GameConfig want;
+        game_config_level_pack(&want, pack);
+        if (want.board_width != state->config.board_width ||
+            want.board_height != state->config.board_height ||
+            want.enemy_count != state->config.enemy_count ||
+            want.enemy_cols != state->config.enemy_cols ||
+            want.enemy_spacing_x != state->config.enemy_spacing_x ||
+            want.enemy_spacing_y != state->config.enemy_spacing_y ||
+            want.shield_count != state->config.shield_count)
+            return false;
+    }
+    else if (!config_valid(&state->config, NULL))
+    {
+        return false;
+    }
+
+    state->levels = pack;
+    state->enemy_direction = 1;
+    state->enemy_move_counter = 0;
+    state->projectile_count = 0;
+    state->enemy_projectile_count = 0;
+    init_level(state);
+    return true;
+}
+
+/**
+ * Copy a state block and rebase its pointers
+ */
+bool game_copy(GameState *dst, const GameState *src)
+{
+    if (!dst || !src || dst->size != src->size)
+        return false;
+
+    Arena *arena = dst->arena;
+    memcpy(dst, src, src->size);
+    dst->arena = arena;
+    layout_state(dst, &dst->config);
+    return true;
+}
+
 /**
  * Free game state
  */
@@ -58,7 +326,8 @@ void game_free(GameState *state)
 {
     if (state)
     {
-        free(state);
+        /* The state lives inside its arena */
+        arena_free(state->arena);
     }
 }
 
@@ -70,8 +339,11 @@ void game_reset(GameState *state)
     if (!state)
         return;
 
-    state->player.x = BOARD_WIDTH / 2 - PLAYER_WIDTH / 2;
-    state->player.y = BOARD_HEIGHT - 2;
+    /* Per-game arena memory goes; the session objects stay */
+    arena_reset(state->arena);
+
+    state->player.x = state->config.board_width / 2 - PLAYER_WIDTH / 2;
+    state->player.y = state->config.board_height - 2;
     state->player.health = INITIAL_LIVES;
     state->player.score = 0;
 
@@ -83,39 +355,196 @@ void game_reset(GameState *state)
 
     state->projectile_count = 0;
     state->enemy_projectile_count = 0;
+    state->projectile_speed = PROJECTILE_SPEED;
 
     state->enemy_direction = 1;
     state->enemy_move_counter = 0;
 
+    init_level(state);
+    push_event(state, GAME_EV_LEVEL_CHANGED, 0, 0, state->level);
+}
+
+/**
+ * Reseed and reset
+ */
+void game_reset_seeded(GameState *state, uint64_t seed)
+{
+    if (!state)
+        return;
+
+    utils_rng_seed(&state->rng, seed);
+    state->enemy_fire_timer = 0;
+    game_reset(state);
+}
+
+/**
+ * Lay out the current level: a record copied out of the level pack, or the
+ * built-in full formation with randomly placed shields
+ */
+static void init_level(GameState *state)
+{
+    if (state->levels)
+    {
+        load_level(state, level_pack_level(state->levels, state->level));
+        return;
+    }
+
+    state->enemy_move_period = ENEMY_MOVE_PERIOD;
+    state->enemy_fire_period = ENEMY_FIRE_RATE;
+    state->enemy_projectile_speed = ENEMY_PROJECTILE_SPEED;
+    state->enemy_aim_chance = 0;
     init_enemies(state);
     init_shields(state);
 }
 
+/**
+ * Copy a level out of the pack. The pack was validated when it was mapped,
+ * so this is straight copies plus rebuilding the derived formation counts.
+ */
+static void load_level(GameState *state, const LevelRecord *record)
+{
+    const LevelShield *shields = level_pack_shields(state->levels, record);
+
+    state->enemy_move_period = record->move_period;
+    state->enemy_fire_period = record->fire_period;
+    state->enemy_projectile_speed = record->shot_speed;
+    state->enemy_aim_chance = record->aim_chance;
+
+    memcpy(state->enemy_alive, level_pack_enemies(record),
+           (size_t)state->enemy_words * sizeof(uint64_t));
+    state->enemy_count = state->config.enemy_count;
+    place_formation(state, record->origin_x, record->origin_y);
+
+    for (int i = 0; i < state->config.shield_count; i++)
+    {
+        state->shields[i].x = shields[i].x;
+        state->shields[i].y = shields[i].y;
+        for (int k = 0; k < SHIELD_HEALTH; k++)
+        {
+            state->shields[i].health[k] = shields[i].mask;
+        }
+    }
+    grid_stamp_shield_columns(state, 0, state->config.board_width - 1);
+}
+
 /**
  * Initialize enemies in grid formation
  */
 static void init_enemies(GameState *state)
 {
-    state->enemy_count = INITIAL_ENEMIES;
-    state->alive_enemy_count = INITIAL_ENEMIES;
+    int n = state->config.enemy_count;
 
-    int enemy_idx = 0;
-    int start_x = 2;
-    int start_y = 2;
-    int spacing_x = 12;
-    int spacing_y = 3;
+    state->enemy_count = n;
+    for (int w = 0; w < state->enemy_words; w++)
+    {
+        int bits = n - w * 64;
+        state->enemy_alive[w] = bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+    }
+
+    place_formation(state, ENEMY_START_X, ENEMY_START_Y);
+}
+
+/**
+ * Put the formation at its level-start origin and rebuild the alive count,
+ * per-column/row counts, shooter index, live extents and enemy grid from
+ * enemy_alive
+ */
+static void place_formation(GameState *state, int origin_x, int origin_y)
+{
+    Formation *f = &state->formation;
+
+    f->origin_x = origin_x;
+    f->origin_y = origin_y;
+    f->spacing_x = state->config.enemy_spacing_x;
+    f->spacing_y = state->config.enemy_spacing_y;
+
+    memset(f->col_alive, 0, (size_t)f->cols * sizeof(int));
+    memset(f->row_alive, 0, (size_t)f->rows * sizeof(int));
+    memset(state->grid.enemy.cols, 0,
+           (size_t)state->grid.enemy.width * state->grid.enemy.words * sizeof(uint64_t));
+    state->alive_count = 0;
+    for (int j = game_next_enemy(state, 0); j >= 0; j = game_next_enemy(state, j + 1))
+    {
+        f->col_alive[j % f->cols]++;
+        f->row_alive[j / f->cols]++;
+        f->col_bottom[j % f->cols] = j / f->cols; /* slots ascend, so the last one wins */
+        state->alive_count++;
+        grid_stamp_enemy(state, j, true);
+    }
 
-    for (int row = 0; row < ENEMY_ROWS && enemy_idx < INITIAL_ENEMIES; row++)
+    f->live_col_count = 0;
+    for (int c = 0; c < f->cols; c++)
     {
-        for (int col = 0; col < ENEMY_COLS && enemy_idx < INITIAL_ENEMIES; col++)
+        if (f->col_alive[c] == 0)
         {
-            state->enemies[enemy_idx].x = start_x + col * spacing_x;
-            state->enemies[enemy_idx].y = start_y + row * spacing_y;
-            state->enemies[enemy_idx].active = true;
-            state->enemies[enemy_idx].health = 1;
-            enemy_idx++;
+            f->col_bottom[c] = -1;
+            continue;
         }
+        f->live_col_pos[c] = f->live_col_count;
+        f->live_cols[f->live_col_count++] = c;
+    }
+
+    f->left_col = f->right_col = f->bottom_row = -1;
+    if (state->alive_count == 0)
+        return;
+
+    f->left_col = 0;
+    while (f->col_alive[f->left_col] == 0)
+        f->left_col++;
+    f->right_col = f->cols - 1;
+    while (f->col_alive[f->right_col] == 0)
+        f->right_col--;
+    f->bottom_row = f->rows - 1;
+    while (f->row_alive[f->bottom_row] == 0)
+        f->bottom_row--;
+}
+
+/**
+ * Remove enemy j from play, move its column's shooter up and shrink the live
+ * formation extents if its column or row became empty
+ */
+static void kill_enemy(GameState *state, int j)
+{
+    Formation *f = &state->formation;
+    int col = j % f->cols;
+    int row = j / f->cols;
+
+    state->enemy_alive[j / 64] &= ~(1ULL << (j % 64));
+    state->alive_count--;
+    grid_stamp_enemy(state, j, false);
+
+    f->col_alive[col]--;
+    f->row_alive[row]--;
+
+    if (f->col_alive[col] == 0)
+    {
+        /* Swap-remove the column from the live list */
+        int last = f->live_cols[--f->live_col_count];
+        f->live_cols[f->live_col_pos[col]] = last;
+        f->live_col_pos[last] = f->live_col_pos[col];
+        f->col_bottom[col] = -1;
+    }
+    else if (row == f->col_bottom[col])
+    {
+        /* The bottom only ever moves up, so each column is walked once per level */
+        do
+            row--;
+        while (!game_enemy_alive(state, row * f->cols + col));
+        f->col_bottom[col] = row;
     }
+
+    if (state->alive_count == 0)
+    {
+        f->left_col = f->right_col = f->bottom_row = -1;
+        return;
+    }
+
+    while (f->col_alive[f->left_col] == 0)
+        f->left_col++;
+    while (f->col_alive[f->right_col] == 0)
+        f->right_col--;
+    while (f->row_alive[f->bottom_row] == 0)
+        f->bottom_row--;
 }
 
 /**
@@ -123,20 +552,133 @@ static void init_enemies(GameState *state)
  */
 static void init_shields(GameState *state)
 {
-    /* Shield positions evenly spaced across board */
-    int shield_positions[] = {rand() % 80, rand() % 80, rand() % 80, rand() % 80};
+    int count = state->config.shield_count;
 
-    for (int i = 0; i < SHIELD_COUNT; i++)
+    /* Shield positions drawn from the game's own generator */
+    for (int i = 0; i < count; i++)
     {
-        state->shields[i].block_count = SHIELD_WIDTH * SHIELD_HEIGHT;
+        state->shields[i].x = utils_rng_int(&state->rng, 0, state->config.board_width - SHIELD_WIDTH);
+    }
 
-        for (int j = 0; j < 2; j++)
+    for (int i = 0; i < count; i++)
+    {
+        Shield *shield = &state->shields[i];
+        shield->y = state->config.board_height - 15 - utils_rng_int(&state->rng, 0, 4);
+        for (int k = 0; k < SHIELD_HEALTH; k++)
         {
-            int block_x = j % SHIELD_WIDTH;
-            int block_y = j / SHIELD_WIDTH;
-            state->shields[i].blocks[j].x = shield_positions[i] + block_x;
-            state->shields[i].blocks[j].y = BOARD_HEIGHT - 15 - (rand() % 5);
-            state->shields[i].blocks[j].health = SHIELD_HEALTH;
+            shield->health[k] = SHIELD_FULL_MASK;
+        }
+    }
+
+    grid_stamp_shield_columns(state, 0, state->config.board_width - 1);
+}
+
+/**
+ * Multi-word tail of grid_first_hit, kept out of line so the single-word
+ * case stays small in the collision loop: visits words w_lo..w_hi of a
+ * column in the direction of travel
+ */
+static int grid_first_hit_words(const uint64_t *col, int w_lo, int w_hi,
+                                uint64_t lo_mask, uint64_t hi_mask, bool up)
+{
+    for (int k = 0; k <= w_hi - w_lo; k++)
+    {
+        int w = up ? w_hi - k : w_lo + k;
+        uint64_t m = col[w];
+        if (w == w_lo)
+            m &= lo_mask;
+        if (w == w_hi)
+            m &= hi_mask;
+        if (m)
+            return w * 64 + (up ? 63 - __builtin_clzll(m) : utils_ctz64(m));
+    }
+    return -1;
+}
+
+/**
+ * Row of the first occupied cell of column x in rows lo..hi (inclusive) met
+ * by a projectile moving up (entering at hi) or down (entering at lo), or -1
+ * if the path is clear; cells outside the layer are empty
+ */
+static inline int grid_first_hit(const GridLayer *layer, int x, int lo, int hi, bool up)
+{
+    if (x < 0 || x >= layer->width)
+        return -1;
+    if (lo < 0)
+        lo = 0;
+    if (hi >= layer->height)
+        hi = layer->height - 1;
+    if (lo > hi)
+        return -1;
+
+    const uint64_t *col = &layer->cols[(size_t)x * layer->words];
+    int w_lo = lo / 64;
+    int w_hi = hi / 64;
+    uint64_t lo_mask = ~0ULL << (lo % 64);
+    uint64_t hi_mask = ~0ULL >> (63 - hi % 64);
+
+    /* Common case: the path lies inside one word */
+    if (w_lo == w_hi)
+    {
+        uint64_t m = col[w_lo] & lo_mask & hi_mask;
+        if (!m)
+            return -1;
+        return w_lo * 64 + (up ? 63 - __builtin_clzll(m) : utils_ctz64(m));
+    }
+
+    return grid_first_hit_words(col, w_lo, w_hi, lo_mask, hi_mask, up);
+}
+
+/**
+ * Set or clear the cells of enemy j in the formation-local enemy layer
+ */
+static void grid_stamp_enemy(GameState *state, int j, bool covered)
+{
+    GridLayer *layer = &state->grid.enemy;
+    int dx = (j % state->formation.cols) * state->formation.spacing_x;
+    int y = (j / state->formation.cols) * state->formation.spacing_y;
+    uint64_t bit = 1ULL << (y % 64);
+
+    for (int x = dx; x < dx + ENEMY_WIDTH; x++)
+    {
+        uint64_t *word = &layer->cols[(size_t)x * layer->words + y / 64];
+        *word = covered ? *word | bit : *word & ~bit;
+    }
+}
+
+/**
+ * Rebuild board columns x_from..x_to of the shield layer from the shield live
+ * masks: each shield column is one byte of its mask placed at the shield row
+ */
+static void grid_stamp_shield_columns(GameState *state, int x_from, int x_to)
+{
+    GridLayer *layer = &state->grid.shield;
+    if (x_from < 0)
+        x_from = 0;
+    if (x_to > layer->width - 1)
+        x_to = layer->width - 1;
+    if (x_from > x_to)
+        return;
+
+    memset(&layer->cols[(size_t)x_from * layer->words], 0,
+           (size_t)(x_to - x_from + 1) * layer->words * sizeof(uint64_t));
+
+    for (int s = 0; s < state->config.shield_count; s++)
+    {
+        const Shield *shield = &state->shields[s];
+        int c_from = x_from - shield->x > 0 ? x_from - shield->x : 0;
+        int c_to = x_to - shield->x < SHIELD_WIDTH - 1 ? x_to - shield->x : SHIELD_WIDTH - 1;
+
+        for (int c = c_from; c <= c_to; c++)
+        {
+            uint64_t *col = &layer->cols[(size_t)(shield->x + c) * layer->words];
+            unsigned bits = (unsigned)(shield->health[0] >> (c * SHIELD_COLUMN_BITS)) & 0xFFu;
+            for (; bits; bits &= bits - 1)
+            {
+                int y = shield->y + __builtin_ctz(bits);
+                if (y >= 0 && y < layer->height)
+                    col[y / 64] |= 1ULL << (y % 64);
+            }
         }
     }
 }
@@ -161,130 +703,148 @@ void game_update(GameState *state)
 }
 
 /**
- * Update enemy positions and fire
+ * Frames between formation move ticks; enemies speed up as they thin out
  */
-static void update_enemies(GameState *state)
+static int enemy_move_period(const GameState *state)
 {
     int enemy_speed = ENEMY_BASE_SPEED;
+    int alive_count = state->alive_count;
 
     /* Increase speed as fewer enemies remain */
-    if (state->alive_enemy_count <= ENEMY_SPEED_INCREASE_THRESHOLD)
+    if (alive_count <= ENEMY_SPEED_INCREASE_THRESHOLD)
     {
         enemy_speed = 2;
     }
-    if (state->alive_enemy_count <= 5)
+    if (alive_count <= 5)
     {
         enemy_speed = 3;
     }
 
+    /* Each speed step takes a frame off the level's period */
+    int period = state->enemy_move_period - (enemy_speed - ENEMY_BASE_SPEED);
+    return period > 1 ? period : 1;
+}
+
+/**
+ * Update enemy positions and fire
+ * A move tick only shifts the formation origin; edge and bottom checks use
+ * the incrementally maintained live extents.
+ */
+static void update_enemies(GameState *state)
+{
+    Formation *f = &state->formation;
+
     /* Move enemies */
     state->enemy_move_counter++;
-    if (state->enemy_move_counter >= (10 - enemy_speed))
+    if (state->enemy_move_counter >= enemy_move_period(state))
     {
         state->enemy_move_counter = 0;
 
-        bool hit_edge = false;
+        f->origin_x += state->enemy_direction;
 
-        for (int i = 0; i < state->enemy_count; i++)
-        {
-            if (!state->enemies[i].active)
-                continue;
-
-            state->enemies[i].x += state->enemy_direction;
-
-            /* Check boundaries */
-            if (state->enemies[i].x <= 0 ||
-                state->enemies[i].x + ENEMY_WIDTH >= BOARD_WIDTH)
-            {
-                hit_edge = true;
-            }
-        }
-
-        /* Change direction and move down if hit edge */
-        if (hit_edge)
+        /* Check boundaries */
+        if (state->alive_count &&
+            (f->origin_x + f->left_col * f->spacing_x <= 0 ||
+             f->origin_x + f->right_col * f->spacing_x + ENEMY_WIDTH >= state->config.board_width))
         {
+            /* Change direction and move down */
             state->enemy_direction *= -1;
-            for (int i = 0; i < state->enemy_count; i++)
+            f->origin_y += ENEMY_MOVE_DOWN;
+
+            /* Check if enemies reached bottom */
+            if (f->origin_y + f->bottom_row * f->spacing_y >= state->config.board_height - 2)
             {
-                if (state->enemies[i].active)
-                {
-                    state->enemies[i].y += ENEMY_MOVE_DOWN;
-
-                    /* Check if enemies reached bottom */
-                    if (state->enemies[i].y >= BOARD_HEIGHT - 2)
-                    {
-                        state->game_over = true;
-                    }
-                }
+                state->game_over = true;
+                push_event(state, GAME_EV_GAME_OVER, 0, 0, 0);
             }
         }
     }
 
     /* Enemy fire */
     state->enemy_fire_timer++;
-    if (state->enemy_fire_timer >= ENEMY_FIRE_RATE)
+    if (state->enemy_fire_timer >= state->enemy_fire_period)
     {
         state->enemy_fire_timer = 0;
 
-        /* Random enemy fires */
-        if (state->alive_enemy_count > 0)
+        /* The bottom enemy of a live column fires */
+        if (state->alive_count)
         {
-            int idx = utils_random_int(0, state->enemy_count - 1);
-
-            for (int attempts = 0; attempts < 5; attempts++)
+            int idx = pick_shooter(state);
+            Projectile *proj = game_projectile_alloc(state->enemy_projectiles,
+                                                     &state->enemy_projectile_count,
+                                                     state->config.max_enemy_projectiles);
+            if (proj)
             {
-                idx = (idx + 1) % state->enemy_count;
-                if (state->enemies[idx].active)
-                {
-                    /* Add enemy projectile */
-                    if (state->enemy_projectile_count < MAX_ENEMY_PROJECTILES)
-                    {
-                        Projectile *proj = &state->enemy_projectiles[state->enemy_projectile_count];
-                        proj->x = state->enemies[idx].x + ENEMY_WIDTH / 2;
-                        proj->y = state->enemies[idx].y + 1;
-                        proj->active = true;
-                        fprintf(stderr, "ENEMY SHOOT: enemy projectile created at (%d,%d) from enemy at (%d,%d)\n",
-                                proj->x, proj->y, state->enemies[idx].x, state->enemies[idx].y);
-                        state->enemy_projectile_count++;
-                    }
-                    break;
-                }
+                int ex = game_enemy_x(state, idx);
+                int ey = game_enemy_y(state, idx);
+                proj->x = ex + ENEMY_WIDTH / 2;
+                proj->y = ey + 1;
+                push_event(state, GAME_EV_ENEMY_SHOT, proj->x, proj->y, idx);
+                LOG_DEBUG(LOG_EV_ENEMY_SHOOT, state->frame_count,
+                          proj->x, proj->y, ex, ey, 0, 0);
             }
         }
     }
 }
 
 /**
- * Update player projectiles
+ * Enemy that fires next, in constant time: with the level's aim chance the
+ * shooter of the column nearest the player (if it has one), otherwise the
+ * shooter of a uniformly random live column
  */
-static void update_projectiles(GameState *state)
+static int pick_shooter(GameState *state)
 {
-    for (int i = 0; i < state->projectile_count; i++)
-    {
-        if (!state->projectiles[i].active)
-            continue;
+    const Formation *f = &state->formation;
 
-        /* Move projectile up by 1 per frame instead of PROJECTILE_SPEED
-         * This ensures we don't skip over enemies during collision detection
-         */
-        state->projectiles[i].y -= 1;
-
-        if (state->projectiles[i].y < 0)
-        {
-            state->projectiles[i].active = false;
-        }
+    if (state->enemy_aim_chance > 0 &&
+        utils_rng_int(&state->rng, 0, 99) < state->enemy_aim_chance)
+    {
+        int px = state->player.x + PLAYER_WIDTH / 2 - ENEMY_WIDTH / 2;
+        int col = utils_clamp((px - f->origin_x + f->spacing_x / 2) / f->spacing_x,
+                              f->left_col, f->right_col);
+        int shooter = game_column_shooter(state, col);
+        if (shooter >= 0)
+            return shooter;
     }
 
-    /* Remove inactive projectiles */
-    int new_count = 0;
-    for (int i = 0; i < state->projectile_count; i++)
+    int col = f->live_cols[utils_rng_int(&state->rng, 0, f->live_col_count - 1)];
+    return game_column_shooter(state, col);
+}
+
+/**
+ * Advance a dense projectile pool
+ * Each shot moves the full distance; handle_collisions sweeps the cells
+ * crossed this frame, so nothing in between is skipped. A shot is dropped
+ * once that whole swept path is off the board.
+ */
+int game_advance_projectiles(Projectile *pool, int count, int dy, int height)
+{
+    for (int i = 0; i < count; i++)
     {
-        if (state->projectiles[i].active)
+        pool[i].y += dy;
+
+        /* Path covers the dy cells ending at the new position */
+        int y_near = pool[i].y - dy + (dy > 0 ? 1 : -1);
+        int y_min = dy > 0 ? y_near : pool[i].y;
+        int y_max = dy > 0 ? pool[i].y : y_near;
+
+        if (y_max < 0 || y_min > height - 1)
         {
-            state->projectiles[new_count++] = state->projectiles[i];
+            game_projectile_release(pool, &count, i--);
         }
     }
-    state->projectile_count = new_count;
+    return count;
+}
+
+/**
+ * Update player projectiles
+ */
+static void update_projectiles(GameState *state)
+{
+    state->projectile_count = game_advance_projectiles(state->projectiles,
+                                                       state->projectile_count,
+                                                       -state->projectile_speed,
+                                                       state->config.board_height);
 }
 
 /**
@@ -292,136 +852,135 @@ static void update_projectiles(GameState *state)
  */
 static void update_enemy_projectiles(GameState *state)
 {
-    for (int i = 0; i < state->enemy_projectile_count; i++)
+    state->enemy_projectile_count = game_advance_projectiles(state->enemy_projectiles,
+                                                             state->enemy_projectile_count,
+                                                             state->enemy_projectile_speed,
+                                                             state->config.board_height);
+}
+
+/**
+ * Apply a projectile hit at cell (x, y) to every shield with a live cell
+ * there. The erosion stencil (the cell and its left/right neighbours) loses
+ * one hit: in thermometer form every plane takes the plane above it inside
+ * the stencil, so the whole shield erodes in SHIELD_HEALTH word operations.
+ */
+static void hit_shields(GameState *state, int x, int y)
+{
+    for (int s = 0; s < state->config.shield_count; s++)
     {
-        if (!state->enemy_projectiles[i].active)
+        Shield *shield = &state->shields[s];
+        int c = x - shield->x;
+        int r = y - shield->y;
+        if (c < 0 || c >= SHIELD_WIDTH || r < 0 || r >= SHIELD_HEIGHT)
             continue;
 
-        state->enemy_projectiles[i].y += ENEMY_PROJECTILE_SPEED;
+        int bit = c * SHIELD_COLUMN_BITS + r;
+        uint64_t cell = 1ULL << bit;
+        if (!(shield->health[0] & cell))
+            continue;
 
-        if (state->enemy_projectiles[i].y >= BOARD_HEIGHT)
+        uint64_t stencil = (cell | (cell << SHIELD_COLUMN_BITS) | (cell >> SHIELD_COLUMN_BITS)) &
+                           SHIELD_FULL_MASK;
+        for (int k = 0; k < SHIELD_HEALTH - 1; k++)
         {
-            state->enemy_projectiles[i].active = false;
+            shield->health[k] = (shield->health[k] & ~stencil) | (shield->health[k + 1] & stencil);
         }
-    }
+        shield->health[SHIELD_HEALTH - 1] &= ~stencil;
 
-    /* Remove inactive projectiles */
-    int new_count = 0;
-    for (int i = 0; i < state->enemy_projectile_count; i++)
-    {
-        if (state->enemy_projectiles[i].active)
-        {
-            state->enemy_projectiles[new_count++] = state->enemy_projectiles[i];
-        }
+        push_event(state, GAME_EV_SHIELD_HIT, x, y, game_shield_cell_health(shield, bit));
     }
-    state->enemy_projectile_count = new_count;
+
+    grid_stamp_shield_columns(state, x - 1, x + 1);
 }
 
 /**
  * Handle all collision detection
+ * Each projectile sweeps the column segment it crossed this frame and stops
+ * at the first occupied cell along its path; an enemy wins a tie with a
+ * shield (player shots) and the player wins a tie with a shield (enemy shots).
  */
 static void handle_collisions(GameState *state)
 {
-    /* Player projectiles vs enemies */
+    const Formation *f = &state->formation;
+    int origin_x = f->origin_x;
+    int origin_y = f->origin_y;
+
+    /* Player projectiles vs enemies and shields: path runs from y + speed - 1 up to y */
     for (int i = 0; i < state->projectile_count; i++)
     {
-        if (!state->projectiles[i].active)
-            continue;
+        Projectile *proj = &state->projectiles[i];
+        int y_near = proj->y + state->projectile_speed - 1;
+        int y_far = proj->y;
 
-        for (int j = 0; j < state->enemy_count; j++)
-        {
-            if (!state->enemies[j].active)
-                continue;
-
-            if (utils_rect_collision(
-                    state->projectiles[i].x, state->projectiles[i].y, 1, 1,
-                    state->enemies[j].x, state->enemies[j].y, ENEMY_WIDTH, ENEMY_HEIGHT))
-            {
+        /* Enemy layer is formation-local; a covered cell's slot follows from the pitch */
+        int lx = proj->x - origin_x;
+        int ly = grid_first_hit(&state->grid.enemy, lx, y_far - origin_y, y_near - origin_y, true);
+        int enemy_y = ly >= 0 ? ly + origin_y : -1;
+        int shield_y = grid_first_hit(&state->grid.shield, proj->x, y_far, y_near, true);
 
-                fprintf(stderr, "HIT! Projectile (%d,%d) hit enemy (%d,%d)\n",
-                        state->projectiles[i].x, state->projectiles[i].y,
-                        state->enemies[j].x, state->enemies[j].y);
-                state->projectiles[i].active = false;
-                state->enemies[j].active = false;
-                state->alive_enemy_count--;
-                state->player.score += POINTS_PER_ENEMY;
-            }
+        if (ly >= 0 && enemy_y >= shield_y)
+        {
+            int j = (ly / f->spacing_y) * f->cols + lx / f->spacing_x;
+            push_event(state, GAME_EV_ENEMY_KILLED, game_enemy_x(state, j), game_enemy_y(state, j), j);
+            LOG_DEBUG(LOG_EV_ENEMY_KILLED, state->frame_count, proj->x, enemy_y,
+                      game_enemy_x(state, j), game_enemy_y(state, j), 0, 0);
+            kill_enemy(state, j);
+            state->player.score += POINTS_PER_ENEMY;
+            game_projectile_release(state->projectiles, &state->projectile_count, i--);
         }
-    }
-
-    /* Player projectiles vs shields */
-    for (int i = 0; i < state->projectile_count; i++)
-    {
-        if (!state->projectiles[i].active)
-            continue;
-
-        for (int s = 0; s < SHIELD_COUNT; s++)
+        else if (shield_y >= 0)
         {
-            for (int b = 0; b < state->shields[s].block_count; b++)
-            {
-                if (state->shields[s].blocks[b].health <= 0)
-                    continue;
-
-                if (utils_rect_collision(
-                        state->projectiles[i].x, state->projectiles[i].y, 1, 1,
-                        state->shields[s].blocks[b].x, state->shields[s].blocks[b].y, 6, 2))
-                {
-
-                    state->projectiles[i].active = false;
-                    state->shields[s].blocks[b].health--;
-                }
-            }
+            hit_shields(state, proj->x, shield_y);
+            game_projectile_release(state->projectiles, &state->projectile_count, i--);
+        }
+        else if (proj->y < 0)
+        {
+            game_projectile_release(state->projectiles, &state->projectile_count, i--);
         }
     }
 
-    /* Enemy projectiles vs player */
+    /* Enemy projectiles vs player and shields: path runs from y - speed + 1 down to y */
     for (int i = 0; i < state->enemy_projectile_count; i++)
     {
-        if (!state->enemy_projectiles[i].active)
-            continue;
-
-        if (utils_rect_collision(
-                state->enemy_projectiles[i].x, state->enemy_projectiles[i].y, 1, 1,
-                state->player.x, state->player.y, PLAYER_WIDTH, PLAYER_HEIGHT))
+        Projectile *proj = &state->enemy_projectiles[i];
+        int y_near = proj->y - state->enemy_projectile_speed + 1;
+        int y_far = proj->y;
+
+        int shield_y = grid_first_hit(&state->grid.shield, proj->x, y_near, y_far, false);
+        bool shield_hit = shield_y >= 0;
+        if (!shield_hit)
+            shield_y = state->config.board_height;
+
+        bool player_hit = proj->x >= state->player.x &&
+                          proj->x < state->player.x + PLAYER_WIDTH &&
+                          state->player.y + PLAYER_HEIGHT > y_near &&
+                          state->player.y <= y_far &&
+                          state->player.y <= shield_y;
+
+        if (player_hit)
         {
-
-            fprintf(stderr, "ENEMY HIT! Enemy projectile (%d,%d) hit player at (%d,%d), health before: %d\n",
-                    state->enemy_projectiles[i].x, state->enemy_projectiles[i].y,
-                    state->player.x, state->player.y, state->player.health);
-            state->enemy_projectiles[i].active = false;
+            int hit_y = state->player.y > y_near ? state->player.y : y_near;
             state->player.health--;
-
-            fprintf(stderr, "Player health after: %d\n", state->player.health);
+            push_event(state, GAME_EV_PLAYER_HIT, proj->x, hit_y, state->player.health);
+            LOG_INFO(LOG_EV_PLAYER_HIT, state->frame_count, proj->x, hit_y,
+                     state->player.x, state->player.y,
+                     state->player.health + 1, state->player.health);
 
             if (state->player.health <= 0)
             {
                 state->game_over = true;
+                push_event(state, GAME_EV_GAME_OVER, 0, 0, 0);
             }
+            game_projectile_release(state->enemy_projectiles, &state->enemy_projectile_count, i--);
         }
-    }
-
-    /* Enemy projectiles vs shields */
-    for (int i = 0; i < state->enemy_projectile_count; i++)
-    {
-        if (!state->enemy_projectiles[i].active)
-            continue;
-
-        for (int s = 0; s < SHIELD_COUNT; s++)
+        else if (shield_hit)
         {
-            for (int b = 0; b < state->shields[s].block_count; b++)
-            {
-                if (state->shields[s].blocks[b].health <= 0)
-                    continue;
-
-                if (utils_rect_collision(
-                        state->enemy_projectiles[i].x, state->enemy_projectiles[i].y, 1, 1,
-                        state->shields[s].blocks[b].x, state->shields[s].blocks[b].y, 6, 2))
-                {
-
-                    state->enemy_projectiles[i].active = false;
-                    state->shields[s].blocks[b].health--;
-                }
-            }
+            hit_shields(state, proj->x, shield_y);
+            game_projectile_release(state->enemy_projectiles, &state->enemy_projectile_count, i--);
+        }
+        else if (proj->y >= state->config.board_height)
+        {
+            game_projectile_release(state->enemy_projectiles, &state->enemy_projectile_count, i--);
         }
     }
 }
@@ -431,7 +990,7 @@ static void handle_collisions(GameState *state)
  */
 static void check_level_complete(GameState *state)
 {
-    if (state->alive_enemy_count <= 0)
+    if (state->alive_count == 0)
     {
         game_next_level(state);
     }
@@ -460,9 +1019,9 @@ void game_move_player_right(GameState *state)
     if (state && !state->is_paused && !state->game_over)
     {
         state->player.x += PLAYER_SPEED;
-        if (state->player.x + PLAYER_WIDTH > BOARD_WIDTH)
+        if (state->player.x + PLAYER_WIDTH > state->config.board_width)
         {
-            state->player.x = BOARD_WIDTH - PLAYER_WIDTH;
+            state->player.x = state->config.board_width - PLAYER_WIDTH;
         }
     }
 }
@@ -474,14 +1033,14 @@ void game_player_shoot(GameState *state)
 {
     if (state && !state->is_paused && !state->game_over)
     {
-        if (state->projectile_count < MAX_PROJECTILES)
+        Projectile *proj = game_projectile_alloc(state->projectiles, &state->projectile_count,
+                                                 state->config.max_projectiles);
+        if (proj)
         {
-            Projectile *proj = &state->projectiles[state->projectile_count];
             proj->x = state->player.x + PLAYER_WIDTH / 2;
             proj->y = state->player.y - 1;
-            proj->active = true;
-            fprintf(stderr, "PLAYER SHOOT: projectile created at (%d,%d)\n", proj->x, proj->y);
-            state->projectile_count++;
+            push_event(state, GAME_EV_PLAYER_SHOT, proj->x, proj->y, 0);
+            LOG_DEBUG(LOG_EV_PLAYER_SHOOT, state->frame_count, proj->x, proj->y, 0, 0, 0, 0);
         }
     }
 }
@@ -497,6 +1056,208 @@ void game_toggle_pause(GameState *state)
     }
 }
 
+/**
+ * Append an event, overwriting the oldest once the ring is full
+ */
+static void push_event(GameState *state, GameEventType type, int x, int y, int value)
+{
+    GameEvent *ev = &state->events.events[state->events.head & (GAME_EVENT_CAPACITY - 1)];
+    ev->type = (uint8_t)type;
+    ev->x = (int16_t)x;
+    ev->y = (int16_t)y;
+    ev->value = value;
+    ev->frame = state->frame_count;
+    state->events.head++;
+}
+
+/**
+ * Cursor at the newest event
+ */
+uint32_t game_event_cursor(const GameState *state)
+{
+    return state ? state->events.head : 0;
+}
+
+/**
+ * Next unread event
+ */
+const GameEvent *game_event_next(const GameState *state, uint32_t *cursor)
+{
+    if (!state || !cursor)
+        return NULL;
+
+    int32_t behind = (int32_t)(state->events.head - *cursor);
+    if (behind <= 0)
+    {
+        /* Caught up, or the state was rolled back past the cursor */
+        *cursor = state->events.head;
+        return NULL;
+    }
+    if (behind > GAME_EVENT_CAPACITY)
+    {
+        *cursor = state->events.head - GAME_EVENT_CAPACITY;
+    }
+
+    return &state->events.events[(*cursor)++ & (GAME_EVENT_CAPACITY - 1)];
+}
+
+/**
+ * Number of enemies still alive
+ */
+int game_alive_enemy_count(const GameState *state)
+{
+    return state ? state->alive_count : 0;
+}
+
+/**
+ * Fold one value into an FNV-1a hash, byte by byte (little-endian order)
+ */
+static uint64_t hash_mix(uint64_t h, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        h ^= (value >> (8 * i)) & 0xFF;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * Hash the simulation state
+ */
+uint64_t game_hash(const GameState *state)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    if (!state)
+        return h;
+
+    h = hash_mix(h, (uint64_t)state->player.x);
+    h = hash_mix(h, (uint64_t)state->player.y);
+    h = hash_mix(h, (uint64_t)state->player.health);
+    h = hash_mix(h, (uint64_t)state->player.score);
+
+    h = hash_mix(h, (uint64_t)state->level);
+    h = hash_mix(h, (uint64_t)state->frame_count);
+    h = hash_mix(h, (uint64_t)state->enemy_fire_timer);
+    h = hash_mix(h, (uint64_t)state->enemy_direction);
+    h = hash_mix(h, (uint64_t)state->enemy_move_counter);
+    h = hash_mix(h, ((uint64_t)state->is_paused << 2) |
+                    ((uint64_t)state->game_over << 1) |
+                    (uint64_t)state->player_won);
+
+    for (int w = 0; w < state->enemy_words; w++)
+    {
+        h = hash_mix(h, state->enemy_alive[w]);
+    }
+    h = hash_mix(h, (uint64_t)state->formation.origin_x);
+    h = hash_mix(h, (uint64_t)state->formation.origin_y);
+
+    /* Only the live prefix of each projectile pool is state */
+    h = hash_mix(h, (uint64_t)state->projectile_count);
+    for (int i = 0; i < state->projectile_count; i++)
+    {
+        const Projectile *p = &state->projectiles[i];
+        h = hash_mix(h, ((uint64_t)(uint32_t)p->x << 32) | (uint32_t)p->y);
+    }
+    h = hash_mix(h, (uint64_t)state->enemy_projectile_count);
+    for (int i = 0; i < state->enemy_projectile_count; i++)
+    {
+        const Projectile *p = &state->enemy_projectiles[i];
+        h = hash_mix(h, ((uint64_t)(uint32_t)p->x << 32) | (uint32_t)p->y);
+    }
+
+    for (int s = 0; s < state->config.shield_count; s++)
+    {
+        h = hash_mix(h, ((uint64_t)(uint32_t)state->shields[s].x << 32) |
+                        (uint32_t)state->shields[s].y);
+        for (int k = 0; k < SHIELD_HEALTH; k++)
+        {
+            h = hash_mix(h, state->shields[s].health[k]);
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        h = hash_mix(h, state->rng.s[i]);
+    }
+    return h;
+}
+
+/**
+ * Closed-form formation position after `frames` frames without kills.
+ * Move ticks come every enemy_move_period() frames; between bounces the
+ * origin travels across a fixed span, so the bounce count and the offset
+ * into the current sweep follow from integer division.
+ */
+void game_formation_at(const GameState *state, int frames,
+                       int *origin_x, int *origin_y, int *direction)
+{
+    if (!state)
+        return;
+
+    const Formation *f = &state->formation;
+    long x = f->origin_x;
+    long y = f->origin_y;
+    int dir = state->enemy_direction;
+
+    if (state->alive_count && frames > 0 && !state->game_over && !state->is_paused)
+    {
+        /* Frames -> move ticks */
+        long period = enemy_move_period(state);
+        long first = period - state->enemy_move_counter;
+        if (first < 1)
+            first = 1;
+        long ticks = frames >= first ? 1 + (frames - first) / period : 0;
+
+        /* Origin x range before an edge is touched */
+        long lo = -(long)f->left_col * f->spacing_x;
+        long hi = state->config.board_width - ENEMY_WIDTH - (long)f->right_col * f->spacing_x;
+        long span = hi - lo;
+
+        /* Ticks until the first bounce, then one bounce per span */
+        long to_edge = dir > 0 ? hi - x : x - lo;
+        if (to_edge < 1)
+            to_edge = 1;
+        if (span < 1)
+            span = 1;
+
+        /* Stop at the drop that brings the formation to the bottom */
+        long rows_left = (state->config.board_height - 2) - (y + (long)f->bottom_row * f->spacing_y);
+        long drops_to_bottom = rows_left <= 0 ? 1 : (rows_left + ENEMY_MOVE_DOWN - 1) / ENEMY_MOVE_DOWN;
+        long bottom_tick = to_edge + (drops_to_bottom - 1) * span;
+        if (ticks > bottom_tick)
+            ticks = bottom_tick;
+
+        if (ticks < to_edge)
+        {
+            x += dir * ticks;
+        }
+        else
+        {
+            long rest = ticks - to_edge;
+            long sweeps = rest / span;
+            long offset = rest % span;
+
+            x += dir * to_edge;
+            dir = -dir;
+            if (sweeps % 2)
+            {
+                x += dir * span;
+                dir = -dir;
+            }
+            x += dir * offset;
+            y += (1 + sweeps) * ENEMY_MOVE_DOWN;
+        }
+    }
+
+    if (origin_x)
+        *origin_x = (int)x;
+    if (origin_y)
+        *origin_y = (int)y;
+    if (direction)
+        *direction = dir;
+}
+
 /**
  * Check if game is over
  */
@@ -513,6 +1274,83 @@ bool game_is_won(GameState *state)
     return state && state->player_won;
 }
 
+/**
+ * Create snapshot ring
+ */
+SnapshotRing *game_snapshot_ring_create(const GameState *state, int capacity)
+{
+    if (!state || capacity < 1)
+        return NULL;
+
+    SnapshotRing *ring = arena_heap_alloc(sizeof(SnapshotRing));
+    if (!ring)
+        return NULL;
+
+    ring->frames = arena_heap_alloc((size_t)capacity * state->size);
+    if (!ring->frames)
+    {
+        arena_heap_free(ring);
+        return NULL;
+    }
+
+    ring->frame_size = state->size;
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->count = 0;
+    return ring;
+}
+
+/**
+ * Free snapshot ring
+ */
+void game_snapshot_ring_free(SnapshotRing *ring)
+{
+    if (ring)
+    {
+        arena_heap_free(ring->frames);
+        arena_heap_free(ring);
+    }
+}
+
+/**
+ * Record a snapshot
+ */
+void game_snapshot(SnapshotRing *ring, const GameState *state)
+{
+    if (!ring || !state || state->size != ring->frame_size)
+        return;
+
+    memcpy(ring->frames + (size_t)ring->head * ring->frame_size, state, ring->frame_size);
+    ring->head = ring->head + 1 == ring->capacity ? 0 : ring->head + 1;
+    if (ring->count < ring->capacity)
+        ring->count++;
+}
+
+/**
+ * Restore a snapshot and rewind the ring to it
+ */
+bool game_restore(SnapshotRing *ring, GameState *state, int frames_back)
+{
+    if (!ring || !state || state->size != ring->frame_size ||
+        frames_back < 0 || frames_back >= ring->count)
+        return false;
+
+    int slot = ring->head - 1 - frames_back;
+    if (slot < 0)
+        slot += ring->capacity;
+
+    /* Stored pointers refer to the recorded state's block; rebase on ours */
+    Arena *arena = state->arena;
+    memcpy(state, ring->frames + (size_t)slot * ring->frame_size, ring->frame_size);
+    state->arena = arena;
+    layout_state(state, &state->config);
+
+    /* The restored frame becomes the most recent snapshot */
+    ring->head = slot + 1 == ring->capacity ? 0 : slot + 1;
+    ring->count -= frames_back;
+    return true;
+}
+
 /**
  * Load high scores from file
  */
@@ -550,22 +1388,23 @@ void game_next_level(GameState *state)
     state->player.score += POINTS_LEVEL_BONUS;
 
     /* Check max level (optional) */
-    if (state->level > 10)
+    if (state->level > MAX_LEVEL)
     {
         state->player_won = true;
         state->game_over = true;
+        push_event(state, GAME_EV_GAME_OVER, 0, 0, 1);
         return;
     }
 
     state->projectile_count = 0;
     state->enemy_projectile_count = 0;
-    init_enemies(state);
-    init_shields(state);
+    init_level(state);
+    push_event(state, GAME_EV_LEVEL_CHANGED, 0, 0, state->level);
 }
 
 /**
- * Set game to a specific level (1-based). Reinitializes enemies/shields and
- * updates player bonuses accordingly.
+ * Seek to a specific level (1-based) in one step. The score is set to the
+ * bonuses of the skipped levels, so repeated seeks never stack bonuses.
  */
 void game_set_level(GameState *state, int level)
 {
@@ -573,10 +1412,20 @@ void game_set_level(GameState *state, int level)
         return;
 
     state->level = level;
-    state->player.score += POINTS_LEVEL_BONUS * (level - 1);
+    state->player.score = POINTS_LEVEL_BONUS * (level - 1);
+
+    if (level > MAX_LEVEL)
+    {
+        state->player_won = true;
+        state->game_over = true;
+        push_event(state, GAME_EV_GAME_OVER, 0, 0, 1);
+        return;
+    }
 
+    state->enemy_direction = 1;
+    state->enemy_move_counter = 0;
     state->projectile_count = 0;
     state->enemy_projectile_count = 0;
-    init_enemies(state);
-    init_shields(state);
+    init_level(state);
+    push_event(state, GAME_EV_LEVEL_CHANGED, 0, 0, level);
 }
@@ -0,0 +1,183 @@
+/*
+ * Space Invaders - Frame Profiler Implementation
+ * Fixed-size histograms in static storage: recording never allocates
+ */
+
+#include "profile.h"
+#include <string.h>
+
+bool profile_active = false;
+
+static bool overlay_visible;
+
+/* Since profile_enable, and since the last overlay refresh */
+static Histogram totals[PROFILE_PHASE_COUNT];
+static Histogram window[PROFILE_PHASE_COUNT];
+static int window_frames;
+
+static char overlay[PROFILE_PHASE_COUNT][PROFILE_OVERLAY_WIDTH];
+
+static const char *const phase_names[PROFILE_PHASE_COUNT] = {
+    "input", "sim", "render", "present", "frame"
+};
+
+/**
+ * Bucket of a sample
+ */
+static int bucket_of(uint64_t ns) {
+    if (ns < PROFILE_SUB_BUCKETS) return (int)ns;
+    
+    int exp = 63 - __builtin_clzll(ns);
+    int sub = (int)(ns >> (exp - PROFILE_SUB_BITS)) & (PROFILE_SUB_BUCKETS - 1);
+    return (exp - PROFILE_SUB_BITS + 1) * PROFILE_SUB_BUCKETS + sub;
+}
+
+/**
+ * Largest value that lands in `bucket`
+ */
+static uint64_t bucket_upper(int bucket) {
+    if (bucket < PROFILE_SUB_BUCKETS) return (uint64_t)bucket;
+    
+    int shift = bucket / PROFILE_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(PROFILE_SUB_BUCKETS + bucket % PROFILE_SUB_BUCKETS);
+    return (sub << shift) + ((1ULL << shift) - 1);
+}
+
+/**
+ * Add a sample to a histogram
+ */
+static void hist_add(Histogram *hist, uint64_t ns) {
+    hist->buckets[bucket_of(ns)]++;
+    hist->count++;
+    hist->total_ns += ns;
+    if (ns > hist->max_ns) hist->max_ns = ns;
+}
+
+/**
+ * Print a duration in at most 7 characters
+ */
+static void format_ns(char *out, size_t size, uint64_t ns) {
+    if (ns < 10000) {
+        snprintf(out, size, "%lluns", (unsigned long long)ns);
+    } else if (ns < 10000000) {
+        snprintf(out, size, "%lluus", (unsigned long long)(ns / 1000));
+    } else if (ns < 10000000000ULL) {
+        snprintf(out, size, "%llums", (unsigned long long)(ns / 1000000));
+    } else {
+        snprintf(out, size, "%llus", (unsigned long long)(ns / 1000000000));
+    }
+}
+
+/**
+ * Format one overlay line from a window histogram
+ */
+static void format_overlay(ProfilePhase phase, const Histogram *hist) {
+    char p50[24], p99[24], p999[24], max[24];
+    format_ns(p50, sizeof(p50), profile_quantile(hist, 0.5));
+    format_ns(p99, sizeof(p99), profile_quantile(hist, 0.99));
+    format_ns(p999, sizeof(p999), profile_quantile(hist, 0.999));
+    format_ns(max, sizeof(max), hist->max_ns);
+    snprintf(overlay[phase], sizeof(overlay[phase]), "%-7s p50 %7.7s p99 %7.7s p999 %7.7s max %7.7s",
+             phase_names[phase], p50, p99, p999, max);
+}
+
+/**
+ * Enable
+ */
+void profile_enable(void) {
+    memset(totals, 0, sizeof(totals));
+    memset(window, 0, sizeof(window));
+    window_frames = 0;
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        snprintf(overlay[p], sizeof(overlay[p]), "%-7s ...", phase_names[p]);
+    }
+    overlay_visible = true;
+    profile_active = true;
+}
+
+/**
+ * Toggle overlay
+ */
+void profile_toggle_overlay(void) {
+    overlay_visible = !overlay_visible;
+}
+
+/**
+ * Overlay visible
+ */
+bool profile_overlay_visible(void) {
+    return profile_active && overlay_visible;
+}
+
+/**
+ * Overlay line
+ */
+const char* profile_overlay_line(ProfilePhase phase) {
+    return overlay[phase];
+}
+
+/**
+ * Record
+ */
+void profile_record(ProfilePhase phase, uint64_t ns) {
+    hist_add(&totals[phase], ns);
+    hist_add(&window[phase], ns);
+}
+
+/**
+ * End of an iteration
+ */
+void profile_frame_end(void) {
+    if (!profile_active || ++window_frames < PROFILE_OVERLAY_WINDOW) return;
+    
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        format_overlay((ProfilePhase)p, &window[p]);
+    }
+    memset(window, 0, sizeof(window));
+    window_frames = 0;
+}
+
+/**
+ * Quantile
+ */
+uint64_t profile_quantile(const Histogram *hist, double q) {
+    if (hist->count == 0) return 0;
+    
+    uint64_t rank = (uint64_t)(q * hist->count + 0.999999);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(b);
+            return upper < hist->max_ns ? upper : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+/**
+ * Histogram
+ */
+const Histogram* profile_histogram(ProfilePhase phase) {
+    return &totals[phase];
+}
+
+/**
+ * Summary
+ */
+void profile_summary(FILE *out) {
+    fprintf(out, "profile: %-7s %9s %9s %9s %9s %9s %9s\n",
+            "phase", "count", "mean", "p50", "p99", "p999", "max");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        const Histogram *hist = &totals[p];
+        char mean[24], p50[24], p99[24], p999[24], max[24];
+        format_ns(mean, sizeof(mean), hist->count ? hist->total_ns / hist->count : 0);
+        format_ns(p50, sizeof(p50), profile_quantile(hist, 0.5));
+        format_ns(p99, sizeof(p99), profile_quantile(hist, 0.99));
+        format_ns(p999, sizeof(p999), profile_quantile(hist, 0.999));
+        format_ns(max, sizeof(max), hist->max_ns);
+        fprintf(out, "profile: %-7s %9llu %9s %9s %9s %9s %9s\n", phase_names[p],
+                (unsigned long long)hist->count, mean, p50, p99, p999, max);
+    }
+}
@@ -0,0 +1,240 @@
+/*
+ * Space Invaders - Replay Implementation
+ * Varint run-length action stream with periodic state-hash keyframes
+ */
+
+#include "replay.h"
+#include "config.h"
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Write an unsigned LEB128 varint
+ */
+static void write_varint(FILE *fp, uint64_t value) {
+    while (value >= 0x80) {
+        fputc((int)((value & 0x7F) | 0x80), fp);
+        value >>= 7;
+    }
+    fputc((int)value, fp);
+}
+
+/**
+ * Read an unsigned LEB128 varint
+ * Returns false on truncated or oversized input
+ */
+static bool read_varint(ReplayReader *reader, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->pos >= reader->size) return false;
+        uint8_t byte = reader->data[reader->pos++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Write a record tag with the pending idle run folded in
+ */
+static void write_record(ReplayWriter *writer, unsigned tag) {
+    write_varint(writer->fp, (writer->pending_none << REPLAY_TAG_BITS) | tag);
+    writer->pending_none = 0;
+}
+
+/**
+ * Open writer
+ */
+ReplayWriter* replay_writer_open(const char *path, uint64_t seed, int start_level,
+                                 uint32_t levels_checksum) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return NULL;
+    
+    ReplayWriter *writer = arena_heap_alloc(sizeof(ReplayWriter));
+    if (!writer) {
+        fclose(fp);
+        return NULL;
+    }
+    
+    writer->fp = fp;
+    writer->frame = 0;
+    writer->pending_none = 0;
+    writer->keyframe_interval = REPLAY_KEYFRAME_INTERVAL;
+    
+    fwrite(REPLAY_MAGIC, 1, 4, fp);
+    fputc(REPLAY_VERSION, fp);
+    write_varint(fp, seed);
+    write_varint(fp, (uint64_t)start_level);
+    write_varint(fp, (uint64_t)writer->keyframe_interval);
+    write_varint(fp, levels_checksum);
+    
+    return writer;
+}
+
+/**
+ * Record a keyframe
+ */
+void replay_writer_keyframe(ReplayWriter *writer, const GameState *state) {
+    if (!writer || !state) return;
+    
+    uint64_t hash = game_hash(state);
+    write_record(writer, REPLAY_TAG_KEYFRAME);
+    write_varint(writer->fp, writer->frame);
+    for (int i = 0; i < 8; i++) {
+        fputc((int)((hash >> (8 * i)) & 0xFF), writer->fp);
+    }
+}
+
+/**
+ * Record a frame
+ */
+void replay_writer_frame(ReplayWriter *writer, ActionSet actions, const GameState *state) {
+    if (!writer) return;
+    
+    actions &= ACTION_GAME_MASK;
+    if (actions == 0) {
+        writer->pending_none++;
+    } else {
+        write_record(writer, actions);
+    }
+    writer->frame++;
+    
+    if (writer->frame % (uint64_t)writer->keyframe_interval == 0) {
+        replay_writer_keyframe(writer, state);
+    }
+}
+
+/**
+ * Close writer
+ */
+void replay_writer_close(ReplayWriter *writer) {
+    if (!writer) return;
+    
+    write_record(writer, REPLAY_TAG_END);
+    fclose(writer->fp);
+    arena_heap_free(writer);
+}
+
+/**
+ * Open reader
+ */
+ReplayReader* replay_reader_open(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "Replay: cannot open %s\n", path);
+        return NULL;
+    }
+    
+    ReplayReader *reader = arena_heap_calloc(sizeof(ReplayReader));
+    if (!reader) {
+        fclose(fp);
+        return NULL;
+    }
+    
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    
+    reader->data = size > 0 ? arena_heap_alloc((size_t)size) : NULL;
+    if (!reader->data || fread(reader->data, 1, (size_t)size, fp) != (size_t)size) {
+        fprintf(stderr, "Replay: cannot read %s\n", path);
+        fclose(fp);
+        replay_reader_close(reader);
+        return NULL;
+    }
+    fclose(fp);
+    reader->size = (size_t)size;
+    
+    uint64_t start_level, interval, levels_checksum = 0;
+    if (reader->size < 5 || memcmp(reader->data, REPLAY_MAGIC, 4) != 0) {
+        fprintf(stderr, "Replay: %s is not a replay\n", path);
+        replay_reader_close(reader);
+        return NULL;
+    }
+    if (reader->data[4] < REPLAY_MIN_VERSION || reader->data[4] > REPLAY_VERSION) {
+        fprintf(stderr, "Replay: %s is a version %d replay; this build reads versions %d-%d\n",
+                path, reader->data[4], REPLAY_MIN_VERSION, REPLAY_VERSION);
+        replay_reader_close(reader);
+        return NULL;
+    }
+    reader->pos = 5;
+    if (!read_varint(reader, &reader->seed) || !read_varint(reader, &start_level) ||
+        !read_varint(reader, &interval) || !read_varint(reader, &levels_checksum)) {
+        fprintf(stderr, "Replay: truncated header in %s\n", path);
+        replay_reader_close(reader);
+        return NULL;
+    }
+    if (reader->data[4] < REPLAY_PACK_MIN_VERSION && levels_checksum != 0) {
+        fprintf(stderr, "Replay: %s is a version %d replay on a level pack; this build reads "
+                "level pack replays from version %d\n", path, reader->data[4], REPLAY_PACK_MIN_VERSION);
+        replay_reader_close(reader);
+        return NULL;
+    }
+    reader->version = reader->data[4];
+    reader->start_level = (int)start_level;
+    reader->keyframe_interval = (int)interval;
+    reader->levels_checksum = (uint32_t)levels_checksum;
+    
+    return reader;
+}
+
+/**
+ * Decode next step
+ */
+ReplayStep replay_reader_next(ReplayReader *reader) {
+    ReplayStep step = {REPLAY_STEP_ERROR, 0, 0, 0};
+    if (!reader) return step;
+    
+    /* Expand the idle run before handing out the record that ended it */
+    if (!reader->has_pending) {
+        uint64_t record;
+        if (!read_varint(reader, &record)) return step;
+        
+        unsigned tag = (unsigned)(record & ((1u << REPLAY_TAG_BITS) - 1));
+        reader->pending_none = record >> REPLAY_TAG_BITS;
+        reader->pending.type = REPLAY_STEP_FRAME;
+        
+        if (tag == REPLAY_TAG_END) {
+            reader->pending.type = REPLAY_STEP_END;
+        } else if (tag == REPLAY_TAG_KEYFRAME) {
+            uint64_t frame;
+            if (!read_varint(reader, &frame) || reader->pos + 8 > reader->size) return step;
+            uint64_t hash = 0;
+            for (int i = 0; i < 8; i++) {
+                hash |= (uint64_t)reader->data[reader->pos++] << (8 * i);
+            }
+            reader->pending.type = REPLAY_STEP_KEYFRAME;
+            reader->pending.frame = frame;
+            reader->pending.hash = hash;
+        } else if (tag <= ACTION_GAME_MASK) {
+            reader->pending.actions = tag;
+        } else {
+            return step;
+        }
+        reader->has_pending = true;
+    }
+    
+    if (reader->pending_none > 0) {
+        reader->pending_none--;
+        step.type = REPLAY_STEP_FRAME;
+        step.actions = 0;
+        return step;
+    }
+    
+    reader->has_pending = false;
+    return reader->pending;
+}
+
+/**
+ * Close reader
+ */
+void replay_reader_close(ReplayReader *reader) {
+    if (reader) {
+        arena_heap_free(reader->data);
+        arena_heap_free(reader);
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Space Invaders - Scene Implementation
+ * The builder walks each model array once, emitting material groups in
+ * order, so the list comes out grouped with no sort
+ */
+
+#include "scene.h"
+#include "arena.h"
+#include "config.h"
+#include "utils.h"
+
+/* Cells a shield mask can hold */
+#define SCENE_SHIELD_CELLS 64
+
+/**
+ * Create scene
+ */
+Scene* scene_create(const GameConfig *config) {
+    Scene *scene = arena_heap_calloc(sizeof(Scene));
+    if (!scene) return NULL;
+    
+    scene->capacity = 1 + config->enemy_count + config->max_projectiles +
+                      config->max_enemy_projectiles + config->shield_count * SCENE_SHIELD_CELLS;
+    scene->rects = arena_heap_alloc((size_t)scene->capacity * sizeof(SceneRect));
+    if (!scene->rects) {
+        arena_heap_free(scene);
+        return NULL;
+    }
+    return scene;
+}
+
+/**
+ * Free scene
+ */
+void scene_free(Scene *scene) {
+    if (!scene) return;
+    arena_heap_free(scene->rects);
+    arena_heap_free(scene);
+}
+
+/**
+ * Append a rectangle clipped to the board; `count` is the list length
+ */
+static void scene_add(Scene *scene, const GameState *state, int *count,
+                      int x, int y, int w, int h) {
+    int x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > state->config.board_width) x1 = state->config.board_width;
+    if (y1 > state->config.board_height) y1 = state->config.board_height;
+    if (x >= x1 || y >= y1 || *count >= scene->capacity) return;
+    
+    scene->rects[(*count)++] = (SceneRect){x, y, x1 - x, y1 - y};
+}
+
+/**
+ * Cells of a shield drawn as `material`, straight from the thermometer
+ * planes: plane k holds the cells with more than k hits left
+ */
+static uint64_t shield_cells(const Shield *shield, Material material) {
+    switch (material) {
+        case MATERIAL_SHIELD:
+            return shield->health[SHIELD_HEALTH - 1];
+        case MATERIAL_SHIELD_DAMAGED:
+            return shield->health[1] & ~shield->health[SHIELD_HEALTH - 1];
+        case MATERIAL_SHIELD_CRUMBLING:
+            return shield->health[0] & ~shield->health[1];
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Build scene
+ */
+void scene_build(Scene *scene, const GameState *state) {
+    int count = 0;
+    
+    scene->group[MATERIAL_PLAYER] = count;
+    scene_add(scene, state, &count, state->player.x, state->player.y, PLAYER_WIDTH, PLAYER_HEIGHT);
+    
+    scene->group[MATERIAL_ENEMY] = count;
+    for (int i = game_next_enemy(state, 0); i >= 0; i = game_next_enemy(state, i + 1)) {
+        scene_add(scene, state, &count, game_enemy_x(state, i), game_enemy_y(state, i),
+                  ENEMY_WIDTH, ENEMY_HEIGHT);
+    }
+    
+    scene->group[MATERIAL_PROJECTILE] = count;
+    for (int i = 0; i < state->projectile_count; i++) {
+        scene_add(scene, state, &count, state->projectiles[i].x, state->projectiles[i].y, 1, 1);
+    }
+    
+    scene->group[MATERIAL_ENEMY_PROJECTILE] = count;
+    for (int i = 0; i < state->enemy_projectile_count; i++) {
+        scene_add(scene, state, &count, state->enemy_projectiles[i].x,
+                  state->enemy_projectiles[i].y, 1, 1);
+    }
+    
+    for (int m = MATERIAL_SHIELD; m <= MATERIAL_SHIELD_CRUMBLING; m++) {
+        scene->group[m] = count;
+        for (int s = 0; s < state->config.shield_count; s++) {
+            const Shield *shield = &state->shields[s];
+            for (uint64_t cells = shield_cells(shield, (Material)m); cells; cells &= cells - 1) {
+                int bit = utils_ctz64(cells);
+                scene_add(scene, state, &count, shield->x + bit / SHIELD_COLUMN_BITS,
+                          shield->y + bit % SHIELD_COLUMN_BITS, 1, 1);
+            }
+        }
+    }
+    
+    scene->group[MATERIAL_COUNT] = count;
+}
@@ -6,6 +6,7 @@
 #define _DEFAULT_SOURCE
 
 #include "utils.h"
+#include <errno.h>
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
@@ -31,16 +32,59 @@ int utils_clamp(int value, int min, int max) {
     return value;
 }
 
+/**
+ * splitmix64 step, used to expand a seed into generator state
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Seed generator
+ */
+void utils_rng_seed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+/**
+ * xoshiro256** step
+ */
+uint64_t utils_rng_next(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+
+    return result;
+}
+
 /**
  * Random integer
  */
-int utils_random_int(int min, int max) {
+int utils_rng_int(Rng *rng, int min, int max) {
     if (min > max) {
         int tmp = min;
         min = max;
         max = tmp;
     }
-    return min + (rand() % (max - min + 1));
+    /* Multiply-shift maps 32 random bits onto the range without a division */
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+    return min + (int)(((utils_rng_next(rng) >> 32) * range) >> 32);
 }
 
 /**
@@ -56,14 +100,70 @@ void utils_sleep_ms(int ms) {
  * Get current time in milliseconds
  */
 unsigned long utils_time_ms(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+    return (unsigned long)(utils_time_ns() / 1000000);
 }
 
 /**
- * Initialize random seed
+ * Monotonic nanoseconds
  */
-void utils_random_seed(void) {
-    srand((unsigned int)time(NULL));
+uint64_t utils_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Absolute-deadline sleep
+ */
+void utils_sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Signals (terminal resize) must not cut the frame short */
+    }
+}
+
+/**
+ * Start a pacer
+ */
+void utils_pacer_start(Pacer *pacer, int rate, uint64_t now_ns) {
+    pacer->start_ns = now_ns;
+    pacer->ticks = 0;
+    pacer->rate = rate > 0 ? rate : 1;
+}
+
+/**
+ * Hand out due ticks
+ */
+int utils_pacer_due(Pacer *pacer, uint64_t now_ns, int max_catchup) {
+    if (now_ns < pacer->start_ns) return 0;
+    
+    /* Ticks due so far: tick k is due once k * 1e9 / rate has elapsed */
+    uint64_t due = (now_ns - pacer->start_ns) * (uint64_t)pacer->rate / 1000000000ULL + 1;
+    if (due <= pacer->ticks) return 0;
+    
+    uint64_t count = due - pacer->ticks;
+    if (count > (uint64_t)max_catchup) {
+        count = (uint64_t)max_catchup;
+    }
+    pacer->ticks = due;
+    return (int)count;
+}
+
+/**
+ * Next deadline
+ */
+uint64_t utils_pacer_next(const Pacer *pacer) {
+    return pacer->start_ns + pacer->ticks * 1000000000ULL / (uint64_t)pacer->rate;
+}
+
+/**
+ * Seed from wall clock and pid
+ */
+uint64_t utils_entropy_seed(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t seed = ((uint64_t)tv.tv_sec << 20) ^ (uint64_t)tv.tv_usec ^ ((uint64_t)getpid() << 40);
+    return splitmix64(&seed);
 }
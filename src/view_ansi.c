@@ -0,0 +1,657 @@
+/*
+ * Space Invaders - View (ANSI) Implementation
+ * Frames are composed in a cell grid, diffed against what the terminal
+ * shows, and sent as cursor moves, SGR colors and glyphs in one write()
+ * wrapped in a synchronized update (DEC mode 2026)
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "view_ansi.h"
+#include "config.h"
+#include "profile.h"
+#include "utils.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Largest screen the view tracks; cells beyond it are never drawn */
+#define ANSI_MAX_ROWS 64
+#define ANSI_MAX_COLS 256
+
+/* Upper bound on the bytes one changed cell costs: cursor move, SGR,
+ * charset switch, glyph, and a few skipped glyphs rewritten in place */
+#define ANSI_CELL_BYTES 32
+
+/* Skipped cells re-sent instead of moving the cursor over them */
+#define ANSI_MAX_REWRITE 4
+
+/* Synchronized update: the terminal holds the frame until the end mark */
+#define ANSI_SYNC_BEGIN "\x1b[?2026h"
+#define ANSI_SYNC_END "\x1b[?2026l"
+
+/* How long an ESC waits for the rest of its sequence before it counts as
+ * the Escape key itself */
+#define ANSI_ESC_TIMEOUT_NS 50000000ULL
+
+/* Cell styles, the colors of the ncurses view */
+enum {
+    STYLE_PLAIN,       /* terminal default colors */
+    STYLE_PLAYER,
+    STYLE_ENEMY,
+    STYLE_PROJECTILE,
+    STYLE_SHIELD,
+    STYLE_TEXT,
+    STYLE_COUNT
+};
+
+/* Style flag: the glyph is from the DEC special graphics (line drawing) set */
+#define STYLE_LINE 0x80
+
+static const char *const style_sgr[STYLE_COUNT] = {
+    "\x1b[0m", "\x1b[32;40m", "\x1b[31;40m", "\x1b[36;40m", "\x1b[33;40m", "\x1b[37;40m"
+};
+
+/* Glyph and style of each scene material */
+static const unsigned char material_glyphs[MATERIAL_COUNT] = {
+    CHAR_PLAYER, CHAR_ENEMY, CHAR_PROJECTILE, CHAR_ENEMY_PROJECTILE,
+    CHAR_SHIELD, CHAR_SHIELD_DAMAGED, CHAR_SHIELD_CRUMBLING
+};
+static const unsigned char material_styles[MATERIAL_COUNT] = {
+    STYLE_PLAYER, STYLE_ENEMY, STYLE_PROJECTILE, STYLE_PROJECTILE,
+    STYLE_SHIELD, STYLE_SHIELD, STYLE_SHIELD
+};
+
+typedef struct {
+    unsigned char ch;
+    unsigned char style;
+} Cell;
+
+/* The frame being composed, what the terminal shows, and the empty board
+ * every frame starts from */
+static Cell frame_cells[ANSI_MAX_ROWS][ANSI_MAX_COLS];
+static Cell shown_cells[ANSI_MAX_ROWS][ANSI_MAX_COLS];
+static Cell blank_cells[ANSI_MAX_ROWS][ANSI_MAX_COLS];
+
+/* Encoded output not yet written */
+static char out_buf[ANSI_MAX_ROWS * ANSI_MAX_COLS * ANSI_CELL_BYTES + 64];
+static size_t out_len;
+
+/* Screen size in use, the board size from the config, and the terminal's
+ * cursor and pen */
+static int rows, cols;
+static int board_width, board_height;
+static int cursor_y, cursor_x;  /* cursor_y < 0: position unknown */
+static int pen;
+
+static struct termios saved_termios;
+static volatile sig_atomic_t active;
+
+/* Undoes what init did to the terminal */
+static const char leave_seq[] = "\x1b[0m\x1b(B\x1b[?25h\x1b[?1049l";
+
+/* Handlers in place before init, put back by cleanup */
+static struct sigaction saved_sigint, saved_sigterm;
+
+/* Input read but not decoded yet: an escape sequence split across reads
+ * waits here for its remaining bytes, and `in_wait_since` is when it
+ * stalled (0 if nothing is waiting) */
+static unsigned char in_buf[64];
+static size_t in_len;
+static uint64_t in_wait_since;
+
+/* UI selected start level (persistent across menu calls) */
+static int view_ansi_ui_level = 1;
+
+/**
+ * Append bytes to the output
+ */
+static void out_put(const char *s, size_t n) {
+    memcpy(out_buf + out_len, s, n);
+    out_len += n;
+}
+
+/**
+ * Write a whole buffer, across partial writes and signals
+ */
+static void write_all(const char *s, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(STDOUT_FILENO, s, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        s += w;
+        n -= (size_t)w;
+    }
+}
+
+/**
+ * Write the pending output
+ */
+static void out_flush(void) {
+    if (out_len == 0) return;
+    out_put(ANSI_SYNC_END, sizeof(ANSI_SYNC_END) - 1);
+    write_all(out_buf, out_len);
+    out_len = 0;
+}
+
+/**
+ * Switch the pen to a cell's style
+ */
+static void set_pen(int style) {
+    if ((style ^ pen) & STYLE_LINE) {
+        out_put(style & STYLE_LINE ? "\x1b(0" : "\x1b(B", 3);
+    }
+    if ((style ^ pen) & ~STYLE_LINE) {
+        const char *sgr = style_sgr[style & ~STYLE_LINE];
+        out_put(sgr, strlen(sgr));
+    }
+    pen = style;
+}
+
+/**
+ * Move the cursor to a cell by the shortest sequence: rewriting a few
+ * skipped glyphs of the current style, a relative move on the same row, or
+ * an absolute move
+ */
+static void move_to(int y, int x) {
+    char seq[32];
+    int n;
+    
+    if (y == cursor_y && x == cursor_x) return;
+    
+    if (y == cursor_y && x > cursor_x) {
+        int gap = x - cursor_x;
+        bool rewrite = gap <= ANSI_MAX_REWRITE;
+        for (int i = cursor_x; rewrite && i < x; i++) {
+            rewrite = shown_cells[y][i].style == pen;
+        }
+        if (rewrite) {
+            for (int i = cursor_x; i < x; i++) {
+                out_put((const char *)&shown_cells[y][i].ch, 1);
+            }
+            cursor_x = x;
+            return;
+        }
+        n = gap == 1 ? snprintf(seq, sizeof(seq), "\x1b[C") :
+                       snprintf(seq, sizeof(seq), "\x1b[%dC", gap);
+    } else if (x == 0) {
+        n = snprintf(seq, sizeof(seq), "\x1b[%dH", y + 1);
+    } else {
+        n = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", y + 1, x + 1);
+    }
+    out_put(seq, (size_t)n);
+    cursor_y = y;
+    cursor_x = x;
+}
+
+/**
+ * Encode every cell of frame_cells that differs from shown_cells
+ */
+static void encode_changes(void) {
+    /* A frame never outgrows the buffer; a second pass over the same frame
+     * (pause over a rendered board) may, so send the first one */
+    if (out_len > sizeof(out_buf) / 2) out_flush();
+    
+    for (int y = 0; y < rows; y++) {
+        if (memcmp(frame_cells[y], shown_cells[y], (size_t)cols * sizeof(Cell)) == 0) continue;
+        for (int x = 0; x < cols; x++) {
+            Cell c = frame_cells[y][x];
+            if (c.ch == shown_cells[y][x].ch && c.style == shown_cells[y][x].style) continue;
+    
+            if (out_len == 0) out_put(ANSI_SYNC_BEGIN, sizeof(ANSI_SYNC_BEGIN) - 1);
+            move_to(y, x);
+            set_pen(c.style);
+            out_put((const char *)&c.ch, 1);
+            shown_cells[y][x] = c;
+    
+            /* Past the last column the cursor waits to wrap; place it
+             * explicitly next time */
+            if (++cursor_x >= cols) cursor_y = -1;
+        }
+    }
+}
+
+/**
+ * Cell of the next frame at screen coordinates; off-screen cells are dropped
+ */
+static void put_cell(int y, int x, unsigned char ch, int style) {
+    if (y >= 0 && y < rows && x >= 0 && x < cols) {
+        frame_cells[y][x] = (Cell){ch, (unsigned char)style};
+    }
+}
+
+/**
+ * Text of the next frame starting at screen coordinates
+ */
+static void put_text(int y, int x, const char *text, int style) {
+    for (int i = 0; text[i]; i++) {
+        put_cell(y, x + i, (unsigned char)text[i], style);
+    }
+}
+
+/**
+ * Lay the border and the empty board into blank_cells, placed where the
+ * ncurses view puts its game window
+ */
+static void build_blank_frame(void) {
+    int top = 1, left = 1;
+    int bottom = top + board_height + 1, right = left + board_width + 1;
+    
+    for (int y = 0; y < ANSI_MAX_ROWS; y++) {
+        for (int x = 0; x < ANSI_MAX_COLS; x++) {
+            blank_cells[y][x] = (Cell){' ', STYLE_PLAIN};
+        }
+    }
+    for (int y = top; y <= bottom && y < ANSI_MAX_ROWS; y++) {
+        for (int x = left; x <= right && x < ANSI_MAX_COLS; x++) {
+            bool edge_y = y == top || y == bottom;
+            bool edge_x = x == left || x == right;
+            unsigned char ch;
+            if (edge_y && edge_x) {
+                ch = y == top ? (x == left ? 'l' : 'k') : (x == left ? 'm' : 'j');
+            } else if (edge_y) {
+                ch = 'q';
+            } else if (edge_x) {
+                ch = 'x';
+            } else {
+                continue;
+            }
+            blank_cells[y][x] = (Cell){ch, STYLE_TEXT | STYLE_LINE};
+        }
+    }
+}
+
+/**
+ * Forget what the terminal shows: clear it and reset pen and cursor
+ */
+static void reset_screen(void) {
+    static const char clear_seq[] = "\x1b[0m\x1b(B\x1b[H\x1b[2J";
+    out_put(clear_seq, sizeof(clear_seq) - 1);
+    for (int y = 0; y < ANSI_MAX_ROWS; y++) {
+        for (int x = 0; x < ANSI_MAX_COLS; x++) {
+            shown_cells[y][x] = (Cell){' ', STYLE_PLAIN};
+        }
+    }
+    pen = STYLE_PLAIN;
+    cursor_y = 0;
+    cursor_x = 0;
+}
+
+/**
+ * SIGINT/SIGTERM while the view is up: restore the terminal the way
+ * cleanup does, using only async-signal-safe calls, then die of the
+ * signal as the process would have
+ */
+static void restore_on_signal(int sig) {
+    if (active) {
+        static const char end_seq[] = ANSI_SYNC_END;
+        write_all(end_seq, sizeof(end_seq) - 1);
+        write_all(leave_seq, sizeof(leave_seq) - 1);
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+        active = false;
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/**
+ * Initialize the terminal
+ */
+bool view_ansi_init(const GameConfig *config) {
+    /* HUD line, then the board inside its border */
+    int need_cols = config->board_width + 3, need_rows = config->board_height + 3;
+    if (need_cols > ANSI_MAX_COLS || need_rows > ANSI_MAX_ROWS) {
+        fprintf(stderr, "Board too large for the ANSI view. Maximum: %dx%d, Board: %dx%d\n",
+                ANSI_MAX_COLS - 3, ANSI_MAX_ROWS - 3, config->board_width, config->board_height);
+        return false;
+    }
+    if (need_cols < MIN_TERM_WIDTH) need_cols = MIN_TERM_WIDTH;
+    if (need_rows < MIN_TERM_HEIGHT) need_rows = MIN_TERM_HEIGHT;
+    
+    struct winsize size;
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) ||
+        tcgetattr(STDIN_FILENO, &saved_termios) != 0 ||
+        ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+        fprintf(stderr, "The ANSI view needs a terminal\n");
+        return false;
+    }
+    if (size.ws_col < need_cols || size.ws_row < need_rows) {
+        fprintf(stderr, "Terminal too small. Minimum: %dx%d, Current: %dx%d\n",
+                need_cols, need_rows, size.ws_col, size.ws_row);
+        return false;
+    }
+    board_width = config->board_width;
+    board_height = config->board_height;
+    rows = size.ws_row < ANSI_MAX_ROWS ? size.ws_row : ANSI_MAX_ROWS;
+    cols = size.ws_col < ANSI_MAX_COLS ? size.ws_col : ANSI_MAX_COLS;
+    
+    /* Raw keys: no line buffering, no echo, no flow control or CR
+     * translation. VMIN = VTIME = 0 makes read() return at once with
+     * whatever is pending. Signals stay on so Ctrl-C still works. */
+    struct termios raw = saved_termios;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO | IEXTEN);
+    raw.c_iflag &= ~(tcflag_t)(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+        fprintf(stderr, "Cannot switch the terminal to raw mode\n");
+        return false;
+    }
+    active = true;
+    in_len = 0;
+    in_wait_since = 0;
+    
+    /* Leave the terminal usable however the process ends */
+    static bool exit_hooked;
+    if (!exit_hooked) {
+        atexit(view_ansi_cleanup);
+        exit_hooked = true;
+    }
+    struct sigaction restore = {0};
+    restore.sa_handler = restore_on_signal;
+    sigemptyset(&restore.sa_mask);
+    sigaction(SIGINT, &restore, &saved_sigint);
+    sigaction(SIGTERM, &restore, &saved_sigterm);
+    /* A signal the parent had us ignore stays ignored */
+    if (saved_sigint.sa_handler == SIG_IGN) sigaction(SIGINT, &saved_sigint, NULL);
+    if (saved_sigterm.sa_handler == SIG_IGN) sigaction(SIGTERM, &saved_sigterm, NULL);
+    
+    /* Alternate screen, hidden cursor */
+    static const char enter_seq[] = "\x1b[?1049h\x1b[?25l";
+    out_len = 0;
+    out_put(enter_seq, sizeof(enter_seq) - 1);
+    reset_screen();
+    write_all(out_buf, out_len);
+    out_len = 0;
+    
+    build_blank_frame();
+    return true;
+}
+
+/**
+ * Cleanup
+ */
+void view_ansi_cleanup(void) {
+    if (!active) return;
+    
+    out_flush();
+    write_all(leave_seq, sizeof(leave_seq) - 1);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+    active = false;
+    sigaction(SIGINT, &saved_sigint, NULL);
+    sigaction(SIGTERM, &saved_sigterm, NULL);
+}
+
+/**
+ * Render game state
+ */
+void view_ansi_render(const GameState *state, const Scene *scene) {
+    if (!active || !state || !scene) return;
+    
+    /* Board origin on screen: inside the border */
+    const int oy = 2, ox = 2;
+    
+    memcpy(frame_cells, blank_cells, sizeof(frame_cells));
+    
+    /* HUD */
+    char hud[96];
+    snprintf(hud, sizeof(hud), "LEVEL: %d | SCORE: %d | LIVES: %d | ENEMIES: %d",
+             state->level, state->player.score, state->player.health,
+             game_alive_enemy_count(state));
+    put_text(0, 2, hud, STYLE_TEXT);
+    
+    /* Scene rectangles, one glyph and style per material */
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        int count;
+        const SceneRect *rect = scene_group(scene, (Material)m, &count);
+        for (int r = 0; r < count; r++, rect++) {
+            for (int y = rect->y; y < rect->y + rect->h; y++) {
+                for (int x = rect->x; x < rect->x + rect->w; x++) {
+                    put_cell(y + oy, x + ox, material_glyphs[m], material_styles[m]);
+                }
+            }
+        }
+    }
+    
+    /* Frame timing overlay over the top-left of the board */
+    if (profile_overlay_visible()) {
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            put_text(p + oy, ox, profile_overlay_line((ProfilePhase)p), STYLE_TEXT);
+        }
+    }
+    
+    encode_changes();
+}
+
+/**
+ * Present
+ */
+void view_ansi_present(void) {
+    out_flush();
+}
+
+/**
+ * Decode one key from the start of `p`: letters as themselves, arrow keys
+ * as 'a'/'d', other escape sequences as -1 in `key`
+ * Returns the bytes the key spans, 0 if its sequence is not complete yet
+ */
+static size_t decode_key(const unsigned char *p, size_t n, int *key) {
+    *key = -1;
+    if (p[0] != 27) {
+        *key = p[0];
+        return 1;
+    }
+    if (n < 2) return 0;
+    if (p[1] == 'O') {
+        /* SS3: a single final byte */
+        if (n < 3) return 0;
+        if (p[2] == 'D') *key = 'a';
+        else if (p[2] == 'C') *key = 'd';
+        return 3;
+    }
+    if (p[1] != '[') {
+        /* ESC ahead of an ordinary key (Alt, or typed quickly) */
+        *key = 27;
+        return 1;
+    }
+    
+    /* CSI: parameter and intermediate bytes, then the final byte, so a
+     * modified arrow such as ESC [1;5D still maps by its final byte */
+    size_t i = 2;
+    while (i < n && p[i] >= 0x20 && p[i] <= 0x3F) i++;
+    if (i == n) return 0;
+    if (p[i] < 0x40 || p[i] > 0x7E) return i;  /* malformed: drop it */
+    if (p[i] == 'D') *key = 'a';
+    else if (p[i] == 'C') *key = 'd';
+    return i + 1;
+}
+
+/**
+ * Keys pending in the terminal, as one call per key: letters as themselves,
+ * arrow keys as 'a'/'d', a lone ESC as 27. Bytes past `max_keys` and
+ * sequences still arriving stay buffered for the next call.
+ * Returns the number of keys stored
+ */
+static int read_keys(int *keys, int max_keys) {
+    int count = 0;
+    
+    while (count < max_keys) {
+        size_t pos = 0;
+        while (pos < in_len && count < max_keys) {
+            int key;
+            size_t used = decode_key(in_buf + pos, in_len - pos, &key);
+            if (used == 0) break;
+            if (key >= 0) keys[count++] = key;
+            pos += used;
+        }
+        if (pos > 0) {
+            in_len -= pos;
+            memmove(in_buf, in_buf + pos, in_len);
+            in_wait_since = 0;
+        }
+        if (count == max_keys) break;
+        
+        /* A sequence longer than the buffer is garbage */
+        if (in_len == sizeof(in_buf)) in_len = 0;
+        ssize_t n = read(STDIN_FILENO, in_buf + in_len, sizeof(in_buf) - in_len);
+        if (n > 0) {
+            in_len += (size_t)n;
+            continue;
+        }
+        
+        /* Input has run dry. A sequence left unfinished for
+         * ANSI_ESC_TIMEOUT_NS began with a lone ESC: hand that out and
+         * decode the bytes after it as ordinary keys. */
+        if (in_len == 0) break;
+        uint64_t now = utils_time_ns();
+        if (in_wait_since == 0) {
+            in_wait_since = now;
+            break;
+        }
+        if (now - in_wait_since < ANSI_ESC_TIMEOUT_NS) break;
+        keys[count++] = 27;
+        in_len--;
+        memmove(in_buf, in_buf + 1, in_len);
+        in_wait_since = 0;
+    }
+    return count;
+}
+
+/**
+ * Handle input: drain every pending key into this tick's action set
+ * Terminals report no key releases, so nothing counts as held
+ */
+TickInput view_ansi_handle_input(void) {
+    TickInput input = {0, 0};
+    int keys[64];
+    int count = read_keys(keys, 64);
+    
+    for (int i = 0; i < count; i++) {
+        switch (keys[i]) {
+            case 'a':
+            case 'A':
+                input.pressed |= ACTION_LEFT;
+                break;
+            case 'd':
+            case 'D':
+                input.pressed |= ACTION_RIGHT;
+                break;
+            case ' ':
+                input.pressed |= ACTION_SHOOT;
+                break;
+            case 'p':
+            case 'P':
+                /* Two presses in one tick cancel out */
+                input.pressed ^= ACTION_PAUSE;
+                break;
+            case 'q':
+            case 'Q':
+            case 27:  /* ESC */
+                input.pressed |= ACTION_QUIT;
+                break;
+            case 'f':
+            case 'F':
+                profile_toggle_overlay();
+                break;
+            default:
+                break;
+        }
+    }
+    
+    return input;
+}
+
+/**
+ * Show pause screen over the rendered frame
+ */
+void view_ansi_show_pause(void) {
+    if (!active) return;
+    
+    put_text(rows / 2 - 1, (cols - 10) / 2, "*** PAUSED ***", STYLE_TEXT);
+    put_text(rows / 2 + 1, (cols - 20) / 2, "Press P to resume, Q to quit", STYLE_TEXT);
+    encode_changes();
+    out_flush();
+}
+
+/**
+ * Show game over screen over the rendered frame
+ */
+void view_ansi_show_game_over(const GameState *state) {
+    if (!active || !state) return;
+    
+    char score[48];
+    snprintf(score, sizeof(score), "Final Score: %d", state->player.score);
+    put_text(rows / 2 - 2, (cols - 12) / 2, "*** GAME OVER ***", STYLE_ENEMY);
+    put_text(rows / 2, (cols - 20) / 2, score, STYLE_TEXT);
+    put_text(rows / 2 + 2, (cols - 20) / 2, "Press Q to quit", STYLE_TEXT);
+    encode_changes();
+    out_flush();
+}
+
+/**
+ * Show main menu
+ */
+Command view_ansi_show_menu(void) {
+    if (!active) return CMD_QUIT;
+    
+    int h = rows, w = cols;
+    int ui_level = view_ansi_ui_level;
+    char level_line[64];
+    
+    for (;;) {
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                frame_cells[y][x] = (Cell){' ', STYLE_PLAIN};
+            }
+        }
+        put_text(h / 2 - 4, (w - 20) / 2, "  SPACE INVADERS  ", STYLE_PLAYER);
+        put_text(h / 2 - 1, (w - 20) / 2, "Controls:", STYLE_TEXT);
+        put_text(h / 2 + 0, (w - 25) / 2, "A/LEFT  - Move Left", STYLE_TEXT);
+        put_text(h / 2 + 1, (w - 25) / 2, "D/RIGHT - Move Right", STYLE_TEXT);
+        put_text(h / 2 + 2, (w - 25) / 2, "SPACE   - Shoot", STYLE_TEXT);
+        put_text(h / 2 + 3, (w - 25) / 2, "P       - Pause", STYLE_TEXT);
+        put_text(h / 2 + 4, (w - 25) / 2, "Q/ESC   - Quit", STYLE_TEXT);
+        snprintf(level_line, sizeof(level_line), "Start Level: [%2d]  (Use LEFT/RIGHT)", ui_level);
+        put_text(h / 2 + 6, (w - 30) / 2, level_line, STYLE_TEXT);
+        put_text(h - 2, (w - 26) / 2, "LEFT/RIGHT to change level, SPACE to start", STYLE_PROJECTILE);
+        encode_changes();
+        out_flush();
+    
+        /* Wait for input: allow left/right to change level */
+        int keys[64];
+        int count;
+        while ((count = read_keys(keys, 64)) == 0) {
+            utils_sleep_ms(50);
+        }
+        for (int i = 0; i < count; i++) {
+            int ch = keys[i];
+            if (ch == 'a' || ch == 'A') {
+                if (ui_level > 1) ui_level--;
+                view_ansi_ui_level = ui_level;
+            } else if (ch == 'd' || ch == 'D') {
+                ui_level++;
+                view_ansi_ui_level = ui_level;
+            } else if (ch == ' ') {
+                return CMD_NONE;  /* Start game */
+            } else if (ch == 'q' || ch == 'Q' || ch == 27) {
+                return CMD_QUIT;
+            }
+        }
+    }
+}
+
+/* UI level setter/getter */
+void view_ansi_set_ui_level(int level) {
+    if (level > 0) view_ansi_ui_level = level;
+}
+
+int view_ansi_get_ui_level(void) {
+    return view_ansi_ui_level;
+}
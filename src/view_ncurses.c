@@ -4,8 +4,10 @@
  */
 
 #include "view_ncurses.h"
+#include "arena.h"
 #include "config.h"
 #include "utils.h"
+#include "profile.h"
 #include <ncurses.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,13 +16,73 @@
 /* Static window reference */
 static WINDOW *game_win = NULL;
 static int max_x, max_y;
+
+/* Game window size (board plus border), from the config at init */
+static int view_rows, view_cols;
+
+/* Terminal size the board and HUD need */
+static int min_term_width = MIN_TERM_WIDTH;
+static int min_term_height = MIN_TERM_HEIGHT;
+
+/* Shadow buffers of the game window, view_rows x view_cols row-major: the
+ * frame being built, what the window holds, and the empty board every
+ * frame starts from. One block, allocated at init. */
+static chtype *frame_cells;
+static chtype *shown_cells;
+static chtype *blank_cells;
+
+/* HUD numbers on screen: level, score, lives, enemies */
+static int hud_values[4];
+
+/* Set when something other than the board was drawn over it */
+static bool full_redraw = true;
+
+/* has_colors(), asked once */
+static bool use_colors;
+
+/* Glyph and color pair of each scene material */
+static const chtype material_glyphs[MATERIAL_COUNT] = {
+    CHAR_PLAYER, CHAR_ENEMY, CHAR_PROJECTILE, CHAR_ENEMY_PROJECTILE,
+    CHAR_SHIELD, CHAR_SHIELD_DAMAGED, CHAR_SHIELD_CRUMBLING
+};
+static const int material_pairs[MATERIAL_COUNT] = {1, 2, 3, 3, 4, 4, 4};
+
 /* UI selected start level (persistent across menu calls) */
 static int view_ncurses_ui_level = 1;
 
+/**
+ * Attribute of a color pair, none on a monochrome terminal
+ */
+static chtype color_attr(int pair) {
+    return use_colors ? (chtype)COLOR_PAIR(pair) : 0;
+}
+
+static void build_blank_frame(void);
+
+/**
+ * Release the shadow buffers
+ */
+static void free_cells(void) {
+    arena_heap_free(frame_cells);
+    frame_cells = shown_cells = blank_cells = NULL;
+}
+
 /**
  * Initialize ncurses
  */
-bool view_ncurses_init(void) {
+bool view_ncurses_init(const GameConfig *config) {
+    /* HUD line, then the board inside its border */
+    view_rows = config->board_height + 2;
+    view_cols = config->board_width + 2;
+    min_term_width = view_cols + 1 > MIN_TERM_WIDTH ? view_cols + 1 : MIN_TERM_WIDTH;
+    min_term_height = view_rows + 1 > MIN_TERM_HEIGHT ? view_rows + 1 : MIN_TERM_HEIGHT;
+    
+    size_t cells = (size_t)view_rows * (size_t)view_cols;
+    frame_cells = arena_heap_alloc(3 * cells * sizeof(chtype));
+    if (!frame_cells) return false;
+    shown_cells = frame_cells + cells;
+    blank_cells = shown_cells + cells;
+    
     /* Initialize ncurses */
     initscr();
     cbreak();
@@ -31,22 +93,40 @@ bool view_ncurses_init(void) {
     
     /* Check terminal size */
     getmaxyx(stdscr, max_y, max_x);
-    if (max_x < MIN_TERM_WIDTH || max_y < MIN_TERM_HEIGHT) {
+    if (max_x < min_term_width || max_y < min_term_height) {
         endwin();
         fprintf(stderr, "Terminal too small. Minimum: %dx%d, Current: %dx%d\n",
-                MIN_TERM_WIDTH, MIN_TERM_HEIGHT, max_x, max_y);
+                min_term_width, min_term_height, max_x, max_y);
+        free_cells();
         return false;
     }
     
     /* Create window */
-    game_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH + 2, 1, 1);
+    game_win = newwin(view_rows, view_cols, 1, 1);
     if (!game_win) {
         endwin();
+        free_cells();
         return false;
     }
     
+    /* The cursor is hidden: leave it wherever the last update put it
+     * instead of moving it back after every refresh */
+    leaveok(stdscr, TRUE);
+    leaveok(game_win, TRUE);
+    
+    /* ncurses parses a parameterized capability and caches it the first
+     * time it sends it, an allocation inside whichever frame first scrolls
+     * part of the screen (the formation stepping down): parse the scrolling
+     * ones now */
+    static const char *const scroll_caps[] = {"csr", "indn", "rin", "il", "dl"};
+    for (size_t i = 0; i < sizeof(scroll_caps) / sizeof(scroll_caps[0]); i++) {
+        char *cap = tigetstr(scroll_caps[i]);
+        if (cap && cap != (char *)-1) tiparm(cap, 0, 0);
+    }
+    
     /* Start color support if available */
-    if (has_colors()) {
+    use_colors = has_colors();
+    if (use_colors) {
         start_color();
         init_pair(1, COLOR_GREEN, COLOR_BLACK);   /* Player */
         init_pair(2, COLOR_RED, COLOR_BLACK);     /* Enemy */
@@ -55,6 +135,13 @@ bool view_ncurses_init(void) {
         init_pair(5, COLOR_WHITE, COLOR_BLACK);   /* Text */
     }
     
+    /* The window starts blank; the first frame sends everything */
+    build_blank_frame();
+    for (size_t i = 0; i < cells; i++) {
+        shown_cells[i] = ' ';
+    }
+    full_redraw = true;
+    
     return true;
 }
 
@@ -68,111 +155,170 @@ void view_ncurses_cleanup(void) {
     }
     curs_set(1);  /* Show cursor */
     endwin();
+    free_cells();
+}
+
+/**
+ * Cell of the next frame at window coordinates; off-window cells are
+ * dropped, as mvwaddch would
+ */
+static void put_cell(int y, int x, chtype ch) {
+    if (y >= 0 && y < view_rows && x >= 0 && x < view_cols) {
+        frame_cells[y * view_cols + x] = ch;
+    }
+}
+
+/**
+ * Lay the border and the empty board into blank_cells
+ */
+static void build_blank_frame(void) {
+    chtype border = color_attr(5);
+    for (int y = 0; y < view_rows; y++) {
+        for (int x = 0; x < view_cols; x++) {
+            bool edge_y = y == 0 || y == view_rows - 1;
+            bool edge_x = x == 0 || x == view_cols - 1;
+            chtype ch = ' ';
+            if (edge_y && edge_x) {
+                ch = y == 0 ? (x == 0 ? ACS_ULCORNER : ACS_URCORNER) :
+                              (x == 0 ? ACS_LLCORNER : ACS_LRCORNER);
+            } else if (edge_y) {
+                ch = ACS_HLINE;
+            } else if (edge_x) {
+                ch = ACS_VLINE;
+            }
+            blank_cells[y * view_cols + x] = ch == ' ' ? ch : ch | border;
+        }
+    }
 }
 
 /**
  * Render game state
+ * The frame is built in frame_cells and only cells that differ from
+ * shown_cells reach the window; the HUD line is rewritten only when one of
+ * its numbers changed. Nothing is staged for output when nothing changed.
  */
-void view_ncurses_render(const GameState *state) {
-    if (!game_win || !state) return;
+void view_ncurses_render(const GameState *state, const Scene *scene) {
+    if (!game_win || !state || !scene) return;
     
-    /* Clear game window */
-    werase(game_win);
+    memcpy(frame_cells, blank_cells, (size_t)view_rows * (size_t)view_cols * sizeof(chtype));
     
-    /* Draw border */
-    wattron(game_win, COLOR_PAIR(5));
-    box(game_win, 0, 0);
-    wattroff(game_win, COLOR_PAIR(5));
-    
-    /* Draw player */
-    if (has_colors()) wattron(game_win, COLOR_PAIR(1));
-    mvwaddch(game_win, state->player.y + 1, state->player.x + 1, CHAR_PLAYER);
-    if (has_colors()) wattroff(game_win, COLOR_PAIR(1));
-    
-    /* Draw enemies */
-    if (has_colors()) wattron(game_win, COLOR_PAIR(2));
-    for (int i = 0; i < state->enemy_count; i++) {
-        if (state->enemies[i].active) {
-            for (int j = 0; j < ENEMY_WIDTH; j++) {
-                mvwaddch(game_win, state->enemies[i].y + 1,
-                        state->enemies[i].x + j + 1, CHAR_ENEMY);
+    /* Scene rectangles, one glyph and color per material */
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        chtype ch = material_glyphs[m] | color_attr(material_pairs[m]);
+        int count;
+        const SceneRect *rect = scene_group(scene, (Material)m, &count);
+        for (int r = 0; r < count; r++, rect++) {
+            for (int y = rect->y; y < rect->y + rect->h; y++) {
+                for (int x = rect->x; x < rect->x + rect->w; x++) {
+                    put_cell(y + 1, x + 1, ch);
+                }
             }
         }
     }
-    if (has_colors()) wattroff(game_win, COLOR_PAIR(2));
     
-    /* Draw player projectiles */
-    if (has_colors()) wattron(game_win, COLOR_PAIR(3));
-    for (int i = 0; i < state->projectile_count; i++) {
-        if (state->projectiles[i].active) {
-            mvwaddch(game_win, state->projectiles[i].y + 1,
-                    state->projectiles[i].x + 1, CHAR_PROJECTILE);
+    /* Frame timing overlay over the top-left of the board */
+    if (profile_overlay_visible()) {
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            const char *line = profile_overlay_line((ProfilePhase)p);
+            for (int x = 0; line[x]; x++) {
+                put_cell(p + 1, x + 1, (chtype)(unsigned char)line[x] | color_attr(5));
+            }
         }
     }
-    if (has_colors()) wattroff(game_win, COLOR_PAIR(3));
     
-    /* Draw enemy projectiles */
-    if (has_colors()) wattron(game_win, COLOR_PAIR(3));
-    for (int i = 0; i < state->enemy_projectile_count; i++) {
-        if (state->enemy_projectiles[i].active) {
-            mvwaddch(game_win, state->enemy_projectiles[i].y + 1,
-                    state->enemy_projectiles[i].x + 1, CHAR_ENEMY_PROJECTILE);
-        }
+    /* A screen drawn over the board (menu, pause, game over) invalidates
+     * what the terminal shows: clear stdscr and resend the whole window */
+    if (full_redraw) {
+        werase(stdscr);
+        touchwin(game_win);
     }
-    if (has_colors()) wattroff(game_win, COLOR_PAIR(3));
     
-    /* Draw shields */
-    if (has_colors()) wattron(game_win, COLOR_PAIR(4));
-    for (int s = 0; s < SHIELD_COUNT; s++) {
-        for (int b = 0; b < state->shields[s].block_count; b++) {
-            if (state->shields[s].blocks[b].health > 0) {
-                mvwaddch(game_win, state->shields[s].blocks[b].y + 1,
-                        state->shields[s].blocks[b].x + 1, CHAR_SHIELD);
+    /* Copy changed cells into the window */
+    bool board_changed = full_redraw;
+    for (int y = 0; y < view_rows; y++) {
+        chtype *frame_row = frame_cells + y * view_cols;
+        chtype *shown_row = shown_cells + y * view_cols;
+        if (memcmp(frame_row, shown_row, (size_t)view_cols * sizeof(chtype)) == 0) continue;
+        for (int x = 0; x < view_cols; x++) {
+            if (frame_row[x] != shown_row[x]) {
+                mvwaddch(game_win, y, x, frame_row[x]);
+                shown_row[x] = frame_row[x];
             }
         }
+        board_changed = true;
     }
-    if (has_colors()) wattroff(game_win, COLOR_PAIR(4));
-    
-    /* Refresh window */
-    wrefresh(game_win);
     
-    /* Draw HUD on main window */
-    attron(COLOR_PAIR(5));
-    mvprintw(0, 2, "LEVEL: %d | SCORE: %d | LIVES: %d | ENEMIES: %d",
-            state->level, state->player.score, state->player.health,
-            state->alive_enemy_count);
-    attroff(COLOR_PAIR(5));
+    /* HUD on the main window */
+    int hud[4] = {state->level, state->player.score, state->player.health,
+                  game_alive_enemy_count(state)};
+    bool hud_changed = full_redraw || memcmp(hud, hud_values, sizeof(hud)) != 0;
+    if (hud_changed) {
+        memcpy(hud_values, hud, sizeof(hud));
+        attron(color_attr(5));
+        mvprintw(0, 2, "LEVEL: %d | SCORE: %d | LIVES: %d | ENEMIES: %d",
+                hud[0], hud[1], hud[2], hud[3]);
+        clrtoeol();
+        attroff(color_attr(5));
+    }
+    full_redraw = false;
     
-    refresh();
+    /* Stage what changed; view_ncurses_present writes it out. stdscr goes
+     * first so the board stays on top of it. */
+    if (hud_changed) wnoutrefresh(stdscr);
+    if (board_changed) wnoutrefresh(game_win);
 }
 
 /**
- * Handle input
+ * Present the staged frame
  */
-Command view_ncurses_handle_input(void) {
-    int ch = getch();
+void view_ncurses_present(void) {
+    doupdate();
+}
+
+/**
+ * Handle input: drain every pending key into this tick's action set
+ * Terminals report no key releases, so nothing counts as held; a held key
+ * arrives as the terminal's auto-repeat presses
+ */
+TickInput view_ncurses_handle_input(void) {
+    TickInput input = {0, 0};
+    int ch;
     
-    switch (ch) {
-        case 'a':
-        case 'A':
-        case KEY_LEFT:
-            return CMD_MOVE_LEFT;
-        case 'd':
-        case 'D':
-        case KEY_RIGHT:
-            return CMD_MOVE_RIGHT;
-        case ' ':
-            return CMD_SHOOT;
-        case 'p':
-        case 'P':
-            return CMD_PAUSE;
-        case 'q':
-        case 'Q':
-        case 27:  /* ESC */
-            return CMD_QUIT;
-        default:
-            return CMD_NONE;
+    while ((ch = getch()) != ERR) {
+        switch (ch) {
+            case 'a':
+            case 'A':
+            case KEY_LEFT:
+                input.pressed |= ACTION_LEFT;
+                break;
+            case 'd':
+            case 'D':
+            case KEY_RIGHT:
+                input.pressed |= ACTION_RIGHT;
+                break;
+            case ' ':
+                input.pressed |= ACTION_SHOOT;
+                break;
+            case 'p':
+            case 'P':
+                /* Two presses in one tick cancel out */
+                input.pressed ^= ACTION_PAUSE;
+                break;
+            case 'q':
+            case 'Q':
+            case 27:  /* ESC */
+                input.pressed |= ACTION_QUIT;
+                break;
+            case 'f':
+            case 'F':
+                profile_toggle_overlay();
+                break;
+            default:
+                break;
+        }
     }
+    
+    return input;
 }
 
 /**
@@ -190,7 +336,7 @@ ViewDimensions view_ncurses_get_dimensions(void) {
 bool view_ncurses_check_size(void) {
     int w, h;
     getmaxyx(stdscr, h, w);
-    return w >= MIN_TERM_WIDTH && h >= MIN_TERM_HEIGHT;
+    return w >= min_term_width && h >= min_term_height;
 }
 
 /**
@@ -199,6 +345,7 @@ bool view_ncurses_check_size(void) {
 void view_ncurses_clear(void) {
     clear();
     refresh();
+    full_redraw = true;
 }
 
 /**
@@ -214,6 +361,7 @@ void view_ncurses_show_pause(void) {
     attroff(COLOR_PAIR(5));
     
     refresh();
+    full_redraw = true;
 }
 
 /**
@@ -235,6 +383,7 @@ void view_ncurses_show_game_over(const GameState *state) {
     attroff(COLOR_PAIR(5));
     
     refresh();
+    full_redraw = true;
 }
 
 /**
@@ -245,6 +394,7 @@ Command view_ncurses_show_menu(void) {
     getmaxyx(stdscr, h, w);
     
     clear();
+    full_redraw = true;
     attron(COLOR_PAIR(1));
     mvprintw(h / 2 - 4, (w - 20) / 2, "  SPACE INVADERS  ");
     attroff(COLOR_PAIR(1));
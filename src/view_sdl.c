@@ -5,6 +5,8 @@
 
 #include "view_sdl.h"
 #include "config.h"
+#include "utils.h"
+#include "profile.h"
 #include <SDL3/SDL.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -17,15 +19,29 @@ static SDL_Renderer *renderer = NULL;
 /* Dimensions */
 /* Size of one game cell in pixels (increase to make the SDL window larger) */
 #define CELL_SIZE 24
-#define WINDOW_WIDTH (BOARD_WIDTH * CELL_SIZE)
-#define WINDOW_HEIGHT (BOARD_HEIGHT * CELL_SIZE)
+/* Board rows and window size in pixels, from the config at init */
+static int board_height;
+static int window_width, window_height;
+/* Font pixel size of the profiler overlay */
+#define OVERLAY_SCALE 2
 
 /* UI selected start level */
 static int view_sdl_ui_level = 1;
 
+/* Color of each scene material; shields dim as their cells erode */
+static const Uint8 material_colors[MATERIAL_COUNT][3] = {
+    {0, 255, 0},      /* player: green */
+    {255, 0, 0},      /* enemies: red */
+    {0, 255, 255},    /* player projectiles: cyan */
+    {255, 255, 0},    /* enemy projectiles: yellow */
+    {0, 100, 255},    /* shield cells: blue */
+    {0, 66, 170},
+    {0, 33, 85}
+};
+
 /* Simple 5x7 font (A-Z, 0-9 and a few symbols). Each char is 5 columns of 7 bits.
  * Stored as rows in LSB (bit0 = top).
- * We'll map characters to indexes: 'A'-'Z' -> 0-25, '0'-'9' -> 26-35, ':'->36, '/'->37, ' '->38
+ * We'll map characters to indexes: 'A'-'Z' -> 0-25, '0'-'9' -> 26-35, ':'->36, '/'->37, ' '->38, '.'->39
  */
 static const uint8_t font5x7[][5] = {
     /* A-Z */
@@ -66,61 +82,270 @@ static const uint8_t font5x7[][5] = {
     {0x40,0x47,0x48,0x50,0x60}, /* 7 */
     {0x36,0x49,0x49,0x49,0x36}, /* 8 */
     {0x32,0x49,0x49,0x49,0x3E}, /* 9 */
-    /* : and / and space */
+    /* : and / and space and . */
     {0x00,0x36,0x36,0x00,0x00}, /* : */
     {0x20,0x10,0x08,0x04,0x02}, /* / */
-    {0x00,0x00,0x00,0x00,0x00}  /* space */
+    {0x00,0x00,0x00,0x00,0x00}, /* space */
+    {0x00,0x60,0x60,0x00,0x00}  /* . */
 };
 
 /* Map character to font index */
-static const uint8_t* font_for_char(char c) {
-    if (c >= 'A' && c <= 'Z') return font5x7[c - 'A'];
-    if (c >= 'a' && c <= 'z') return font5x7[c - 'a'];
-    if (c >= '0' && c <= '9') return font5x7[26 + (c - '0')];
-    if (c == ':') return font5x7[36];
-    if (c == '/') return font5x7[37];
-    return font5x7[38];
+static int font_index(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= '0' && c <= '9') return 26 + (c - '0');
+    if (c == ':') return 36;
+    if (c == '/') return 37;
+    if (c == '.') return 39;
+    return 38;
 }
 
-/* Draw a text string at cell coordinates (x,y) where each font pixel = CELL_SIZE */
-static void draw_text(int cx, int cy, const char *s, Uint8 r, Uint8 g, Uint8 b) {
-    if (!renderer || !s) return;
-    int px = cx * CELL_SIZE;
-    int py = cy * CELL_SIZE;
+/* Glyph cell of the font in font pixels, and the pen advance per character */
+#define FONT_GLYPHS (int)(sizeof(font5x7) / sizeof(font5x7[0]))
+#define GLYPH_WIDTH 5
+#define GLYPH_HEIGHT 7
+#define GLYPH_ADVANCE 6
+
+/* Every glyph rasterized once at init, one texel per font pixel, white on
+ * transparent: the text color is the texture's color mod */
+static SDL_Texture *font_atlas = NULL;
+
+/* Rendered strings keyed by their content, so unchanged text is one
+ * textured quad. Each slot owns a streaming texture wide enough for
+ * TEXT_CACHE_CHARS glyphs, created with the view; a miss rasterizes the
+ * string into the least recently used slot on the CPU, because switching
+ * render targets mid-frame stalls GL renderers on a flush. */
+#define TEXT_CACHE_SLOTS 16
+#define TEXT_CACHE_CHARS PROFILE_OVERLAY_WIDTH
+
+typedef struct {
+    SDL_Texture *texture;
+    char text[TEXT_CACHE_CHARS];
+    int length;
+    Uint64 last_used;
+} TextCacheEntry;
+
+static TextCacheEntry text_cache[TEXT_CACHE_SLOTS];
+static Uint64 text_cache_clock;
+
+/* Fill rectangles collected for the current draw color, submitted together
+ * with SDL_RenderFillRects; a full batch is sent and restarted */
+#define BATCH_RECTS 1024
+static SDL_FRect batch[BATCH_RECTS];
+static int batch_count;
 
+/* Renderer calls since the last view_sdl_render started */
+static int draw_calls;
+
+/**
+ * Submit the collected rectangles in one call
+ */
+static void batch_flush(void) {
+    if (batch_count == 0) return;
+    SDL_RenderFillRects(renderer, batch, batch_count);
+    draw_calls++;
+    batch_count = 0;
+}
+
+/**
+ * Start a batch in a new color, sending the previous one
+ */
+static void batch_color(Uint8 r, Uint8 g, Uint8 b) {
+    batch_flush();
     SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-    while (*s) {
-        const uint8_t *glyph = font_for_char(*s);
-        for (int col = 0; col < 5; col++) {
-            uint8_t colbits = glyph[col];
-            for (int row = 0; row < 7; row++) {
-                if (colbits & (1 << row)) {
-                    SDL_FRect rct = {
-                        .x = px + col * CELL_SIZE,
-                        .y = py + row * CELL_SIZE,
-                        .w = CELL_SIZE,
-                        .h = CELL_SIZE
-                    };
-                    SDL_RenderFillRect(renderer, &rct);
-                }
-            }
+    draw_calls++;
+}
+
+/**
+ * Add a rectangle in pixels to the batch
+ */
+static void batch_add(float x, float y, float w, float h) {
+    if (batch_count == BATCH_RECTS) batch_flush();
+    batch[batch_count++] = (SDL_FRect){.x = x, .y = y, .w = w, .h = h};
+}
+
+/**
+ * Write glyph `glyph` into RGBA32 pixels with its top-left corner at
+ * column x: font pixels opaque white, the rest of the cell transparent
+ */
+static void rasterize_glyph(void *pixels, int pitch, int x, int glyph) {
+    for (int row = 0; row < GLYPH_HEIGHT; row++) {
+        Uint32 *line = (Uint32 *)((Uint8 *)pixels + row * pitch) + x;
+        for (int col = 0; col < GLYPH_WIDTH; col++) {
+            line[col] = (font5x7[glyph][col] & (1 << row)) ? 0xFFFFFFFFu : 0;
         }
-        /* advance: char width 6 cells (5 + 1 space) */
-        px += 6 * CELL_SIZE;
-        s++;
     }
 }
 
+/**
+ * Rasterize the font into a new atlas texture, glyph i at x = i * GLYPH_WIDTH
+ */
+static SDL_Texture* create_font_atlas(void) {
+    SDL_Surface *surface = SDL_CreateSurface(FONT_GLYPHS * GLYPH_WIDTH, GLYPH_HEIGHT,
+                                             SDL_PIXELFORMAT_RGBA32);
+    if (!surface) return NULL;
+    
+    for (int g = 0; g < FONT_GLYPHS; g++) {
+        rasterize_glyph(surface->pixels, surface->pitch, g * GLYPH_WIDTH, g);
+    }
+    
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    }
+    return texture;
+}
+
+/**
+ * Create the font atlas and the string cache's textures
+ */
+static bool font_init(void) {
+    font_atlas = create_font_atlas();
+    if (!font_atlas) return false;
+    
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                                 SDL_TEXTUREACCESS_STREAMING,
+                                                 TEXT_CACHE_CHARS * GLYPH_ADVANCE, GLYPH_HEIGHT);
+        if (!texture) return false;
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+        text_cache[i] = (TextCacheEntry){.texture = texture};
+    }
+    text_cache_clock = 0;
+    return true;
+}
+
+/**
+ * Destroy the font atlas and the string cache's textures
+ */
+static void font_cleanup(void) {
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        if (text_cache[i].texture) SDL_DestroyTexture(text_cache[i].texture);
+    }
+    memset(text_cache, 0, sizeof(text_cache));
+    if (font_atlas) {
+        SDL_DestroyTexture(font_atlas);
+        font_atlas = NULL;
+    }
+}
+
+/**
+ * Blit `length` glyphs from the atlas at pixel (px,py), each font pixel
+ * `scale` pixels, in the atlas's current color mod
+ */
+static void blit_glyphs(const char *s, int length, float px, float py, float scale) {
+    for (int i = 0; i < length; i++) {
+        SDL_FRect src = {
+            .x = (float)(font_index(s[i]) * GLYPH_WIDTH),
+            .y = 0,
+            .w = GLYPH_WIDTH,
+            .h = GLYPH_HEIGHT
+        };
+        SDL_FRect dst = {
+            .x = px + i * GLYPH_ADVANCE * scale,
+            .y = py,
+            .w = GLYPH_WIDTH * scale,
+            .h = GLYPH_HEIGHT * scale
+        };
+        SDL_RenderTexture(renderer, font_atlas, &src, &dst);
+    }
+    draw_calls += length;
+}
+
+/**
+ * Cached texture of a string, rasterizing it into the least recently used
+ * slot on a miss. Returns NULL if the slot cannot be written.
+ */
+static TextCacheEntry* text_cache_get(const char *s, int length) {
+    TextCacheEntry *slot = &text_cache[0];
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        TextCacheEntry *entry = &text_cache[i];
+        if (entry->length == length && memcmp(entry->text, s, length) == 0) {
+            entry->last_used = ++text_cache_clock;
+            return entry;
+        }
+        if (entry->last_used < slot->last_used) slot = entry;
+    }
+    
+    /* Glyph cells and the gaps between them: every texel the quad shows */
+    SDL_Rect area = {0, 0, length * GLYPH_ADVANCE, GLYPH_HEIGHT};
+    void *pixels;
+    int pitch;
+    slot->length = 0;
+    if (!slot->texture || !SDL_LockTexture(slot->texture, &area, &pixels, &pitch)) return NULL;
+    for (int i = 0; i < length; i++) {
+        rasterize_glyph(pixels, pitch, i * GLYPH_ADVANCE, font_index(s[i]));
+        for (int row = 0; row < GLYPH_HEIGHT; row++) {
+            ((Uint32 *)((Uint8 *)pixels + row * pitch))[i * GLYPH_ADVANCE + GLYPH_WIDTH] = 0;
+        }
+    }
+    SDL_UnlockTexture(slot->texture);
+    draw_calls += 2;
+    
+    memcpy(slot->text, s, length);
+    slot->length = length;
+    slot->last_used = ++text_cache_clock;
+    return slot;
+}
+
+/* Draw a text string at pixel (px,py) where each font pixel = `scale` pixels:
+ * one quad from the string cache, or one atlas blit per character for
+ * text the cache cannot hold */
+static void draw_text_px(int px, int py, int scale, const char *s, Uint8 r, Uint8 g, Uint8 b) {
+    if (!renderer || !font_atlas || !s) return;
+    
+    int length = (int)strlen(s);
+    if (length == 0) return;
+    
+    /* Queued fills go first, so text stays on top of them */
+    batch_flush();
+    TextCacheEntry *entry = length <= TEXT_CACHE_CHARS ? text_cache_get(s, length) : NULL;
+    if (entry) {
+        SDL_FRect src = {
+            .x = 0,
+            .y = 0,
+            .w = length * GLYPH_ADVANCE - 1,
+            .h = GLYPH_HEIGHT
+        };
+        SDL_FRect dst = {
+            .x = px,
+            .y = py,
+            .w = src.w * scale,
+            .h = src.h * scale
+        };
+        SDL_SetTextureColorMod(entry->texture, r, g, b);
+        SDL_RenderTexture(renderer, entry->texture, &src, &dst);
+        draw_calls += 2;
+        return;
+    }
+    
+    SDL_SetTextureColorMod(font_atlas, r, g, b);
+    draw_calls++;
+    blit_glyphs(s, length, px, py, scale);
+}
+
+/* Draw a text string at cell coordinates (x,y) where each font pixel = CELL_SIZE */
+static void draw_text(int cx, int cy, const char *s, Uint8 r, Uint8 g, Uint8 b) {
+    draw_text_px(cx * CELL_SIZE, cy * CELL_SIZE, CELL_SIZE, s, r, g, b);
+}
+
 /**
  * Initialize SDL3 view
  */
-bool view_sdl_init(void) {
+bool view_sdl_init(const GameConfig *config) {
+    board_height = config->board_height;
+    window_width = config->board_width * CELL_SIZE;
+    window_height = config->board_height * CELL_SIZE;
+    
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
         return false;
     }
     
-    window = SDL_CreateWindow("Space Invaders", WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    window = SDL_CreateWindow("Space Invaders", window_width, window_height, 0);
     if (!window) {
         fprintf(stderr, "SDL_CreateWindow failed: %s\n", SDL_GetError());
         SDL_Quit();
@@ -135,6 +360,17 @@ bool view_sdl_init(void) {
         return false;
     }
     
+    if (!font_init()) {
+        fprintf(stderr, "Font texture creation failed: %s\n", SDL_GetError());
+        font_cleanup();
+        SDL_DestroyRenderer(renderer);
+        renderer = NULL;
+        SDL_DestroyWindow(window);
+        window = NULL;
+        SDL_Quit();
+        return false;
+    }
+    
     return true;
 }
 
@@ -142,6 +378,7 @@ bool view_sdl_init(void) {
  * Cleanup SDL3 view
  */
 void view_sdl_cleanup(void) {
+    font_cleanup();
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = NULL;
@@ -153,108 +390,114 @@ void view_sdl_cleanup(void) {
     SDL_Quit();
 }
 
-/**
- * Draw a filled rectangle
- */
-static void draw_rect(int x, int y, int w, int h, 
-                     Uint8 r, Uint8 g, Uint8 b) {
-    if (!renderer) return;
-    
-    SDL_FRect rect = {
-        .x = x * CELL_SIZE,
-        .y = y * CELL_SIZE,
-        .w = w * CELL_SIZE,
-        .h = h * CELL_SIZE
-    };
-    
-    SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-    SDL_RenderFillRect(renderer, &rect);
-}
-
 /**
  * Render game state
  */
-void view_sdl_render(const GameState *state) {
-    if (!renderer || !state) return;
+void view_sdl_render(const GameState *state, const Scene *scene) {
+    if (!renderer || !state || !scene) return;
+    
+    draw_calls = 0;
     
     /* Clear screen (black background) */
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
+    draw_calls += 2;
     
-    /* Draw player (green) */
-    draw_rect(state->player.x, state->player.y, 
-              PLAYER_WIDTH, PLAYER_HEIGHT, 0, 255, 0);
-    
-    /* Draw enemies (red) */
-    for (int i = 0; i < state->enemy_count; i++) {
-        if (state->enemies[i].active) {
-            draw_rect(state->enemies[i].x, state->enemies[i].y,
-                     ENEMY_WIDTH, ENEMY_HEIGHT, 255, 0, 0);
-        }
-    }
-    
-    /* Draw player projectiles (cyan) */
-    for (int i = 0; i < state->projectile_count; i++) {
-        if (state->projectiles[i].active) {
-            draw_rect(state->projectiles[i].x, state->projectiles[i].y,
-                     1, 1, 0, 255, 255);
-        }
-    }
-    
-    /* Draw enemy projectiles (yellow) */
-    for (int i = 0; i < state->enemy_projectile_count; i++) {
-        if (state->enemy_projectiles[i].active) {
-            draw_rect(state->enemy_projectiles[i].x, state->enemy_projectiles[i].y,
-                     1, 1, 255, 255, 0);
-        }
-    }
-    
-    /* Draw shields (blue) - make blocks 2x2 for visibility */
-    for (int s = 0; s < SHIELD_COUNT; s++) {
-        for (int b = 0; b < state->shields[s].block_count; b++) {
-            if (state->shields[s].blocks[b].health > 0) {
-                draw_rect(state->shields[s].blocks[b].x, state->shields[s].blocks[b].y,
-                         6, 2, 0, 100, 255);
-            }
+    /* Scene rectangles: one color change and one fill call per material */
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        const Uint8 *c = material_colors[m];
+        int count;
+        const SceneRect *rect = scene_group(scene, (Material)m, &count);
+        if (count == 0) continue;
+        batch_color(c[0], c[1], c[2]);
+        for (int r = 0; r < count; r++, rect++) {
+            batch_add(rect->x * CELL_SIZE, rect->y * CELL_SIZE,
+                      rect->w * CELL_SIZE, rect->h * CELL_SIZE);
         }
     }
+    batch_flush();
     
     /* Draw HUD text (simple version without fonts) */
     /* For now, just show a basic border */
     SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
-    SDL_RenderLine(renderer, 0, (BOARD_HEIGHT + 1) * CELL_SIZE,
-                  WINDOW_WIDTH, (BOARD_HEIGHT + 1) * CELL_SIZE);
+    SDL_RenderLine(renderer, 0, (board_height + 1) * CELL_SIZE,
+                  window_width, (board_height + 1) * CELL_SIZE);
+    draw_calls += 2;
     
-    /* Present frame */
-    SDL_RenderPresent(renderer);
+    /* Frame timing overlay, small print on a dark panel in the top-left corner */
+    if (profile_overlay_visible()) {
+        const int line_height = 9 * OVERLAY_SCALE;
+        SDL_FRect panel = {
+            .x = 0,
+            .y = 0,
+            .w = PROFILE_OVERLAY_WIDTH * 6 * OVERLAY_SCALE,
+            .h = PROFILE_PHASE_COUNT * line_height + 2 * OVERLAY_SCALE
+        };
+        SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
+        SDL_RenderFillRect(renderer, &panel);
+        draw_calls += 2;
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            draw_text_px(2 * OVERLAY_SCALE, 2 * OVERLAY_SCALE + p * line_height, OVERLAY_SCALE,
+                         profile_overlay_line((ProfilePhase)p), 200, 200, 200);
+        }
+    }
+}
+
+/**
+ * Draw calls
+ */
+int view_sdl_draw_calls(void) {
+    return draw_calls;
+}
+
+/**
+ * Present the rendered frame
+ */
+void view_sdl_present(void) {
+    if (renderer) {
+        SDL_RenderPresent(renderer);
+    }
 }
 
 /**
- * Handle SDL input
+ * Handle SDL input: drain the event queue, then sample held movement keys
+ * OS key repeat is ignored except for the shot, which keeps auto-firing
  */
-Command view_sdl_handle_input(void) {
+TickInput view_sdl_handle_input(void) {
+    TickInput input = {0, 0};
     SDL_Event event;
     
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
             case SDL_EVENT_QUIT:
-                return CMD_QUIT;
+                input.pressed |= ACTION_QUIT;
+                break;
             
             case SDL_EVENT_KEY_DOWN:
+                if (event.key.repeat && event.key.key != SDLK_SPACE) break;
                 switch (event.key.key) {
                     case SDLK_A:
                     case SDLK_LEFT:
-                        return CMD_MOVE_LEFT;
+                        input.pressed |= ACTION_LEFT;
+                        break;
                     case SDLK_D:
                     case SDLK_RIGHT:
-                        return CMD_MOVE_RIGHT;
+                        input.pressed |= ACTION_RIGHT;
+                        break;
                     case SDLK_SPACE:
-                        return CMD_SHOOT;
+                        input.pressed |= ACTION_SHOOT;
+                        break;
                     case SDLK_P:
-                        return CMD_PAUSE;
+                        /* Two presses in one tick cancel out */
+                        input.pressed ^= ACTION_PAUSE;
+                        break;
                     case SDLK_Q:
                     case SDLK_ESCAPE:
-                        return CMD_QUIT;
+                        input.pressed |= ACTION_QUIT;
+                        break;
+                    case SDLK_F:
+                        profile_toggle_overlay();
+                        break;
                     default:
                         break;
                 }
@@ -265,7 +508,12 @@ Command view_sdl_handle_input(void) {
         }
     }
     
-    return CMD_NONE;
+    /* Held keys by scancode: the state after every queued event */
+    const bool *keys = SDL_GetKeyboardState(NULL);
+    if (keys[SDL_SCANCODE_A] || keys[SDL_SCANCODE_LEFT]) input.held |= ACTION_LEFT;
+    if (keys[SDL_SCANCODE_D] || keys[SDL_SCANCODE_RIGHT]) input.held |= ACTION_RIGHT;
+    
+    return input;
 }
 
 /**
@@ -280,8 +528,8 @@ void view_sdl_show_pause(void) {
     
     /* Draw pause indicator (simple white rectangle) */
     SDL_FRect rect = {
-        .x = WINDOW_WIDTH / 2 - 50,
-        .y = WINDOW_HEIGHT / 2 - 25,
+        .x = window_width / 2 - 50,
+        .y = window_height / 2 - 25,
         .w = 100,
         .h = 50
     };
@@ -302,8 +550,8 @@ void view_sdl_show_game_over(const GameState *state) {
     
     /* Draw game over indicator */
     SDL_FRect rect = {
-        .x = WINDOW_WIDTH / 2 - 75,
-        .y = WINDOW_HEIGHT / 2 - 50,
+        .x = window_width / 2 - 75,
+        .y = window_height / 2 - 50,
         .w = 150,
         .h = 100
     };
@@ -331,7 +579,7 @@ Command view_sdl_show_menu(void) {
     draw_text(4, 6, "LEFT/RIGHT - Change Level", 200, 200, 200);
     draw_text(4, 9, "SPACE - Start", 200, 200, 200);
     draw_text(4, 12, "Q - Quit", 200, 200, 200);
-
+    
     char level_label[32];
     snprintf(level_label, sizeof(level_label), "LEVEL %d", view_sdl_ui_level);
     draw_text(10, 16, level_label, 0, 180, 255);
@@ -0,0 +1,253 @@
+/*
+ * Space Invaders - Level Pack Builder
+ * Compiles a text level description into the binary pack the game maps
+ *
+ * Usage: levelpack INPUT.txt OUTPUT.pack
+ *
+ * Text format, one directive per line, '#' starts a comment:
+ *   board W H                 board size (once, before the first level)
+ *   formation COLS PX PY      slots per row and slot pitch (once)
+ *   level                     start a new level; timings, origin and shield
+ *                             positions carry over from the previous level
+ *   period N                  frames between formation steps at full strength
+ *   fire N                    frames between enemy shots
+ *   shot N                    enemy projectile speed (cells per frame)
+ *   aim N                     percent of shots fired from the column over the player
+ *   origin X Y                formation origin at level start
+ *   row PATTERN               next formation row, one character per column:
+ *                             'o' = enemy, '.' = empty slot
+ *   shield X Y [PATTERN]      a shield; PATTERN gives its rows top to bottom
+ *                             separated by '/', 'o' = live cell (default: full)
+ * The formation has as many rows as the tallest level, and every level must
+ * have the same number of shields.
+ */
+
+#include "levels.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PACK_MAX_LEVELS 256
+#define PACK_MAX_ROWS 64
+#define PACK_MAX_COLS 64
+#define PACK_MAX_SHIELDS 64
+
+/* One level as read from the text */
+typedef struct {
+    LevelRecord record;
+    char rows[PACK_MAX_ROWS][PACK_MAX_COLS + 1];
+    int row_count;
+    LevelShield shields[PACK_MAX_SHIELDS];
+    int shield_count;
+    bool shields_given;  /* a shield line replaced the inherited set */
+} PackLevel;
+
+static PackLevel levels[PACK_MAX_LEVELS];
+
+/**
+ * Report a syntax error and fail
+ */
+static int parse_error(const char *path, int line, const char *message) {
+    fprintf(stderr, "%s:%d: %s\n", path, line, message);
+    return EXIT_FAILURE;
+}
+
+/**
+ * Shield mask from a picture such as "oooooo/oo..oo"; an empty picture is a
+ * full shield
+ * Returns false if the picture is larger than a shield
+ */
+static bool shield_mask(const char *picture, uint64_t *mask) {
+    int row = 0, col = 0;
+    *mask = 0;
+    if (!*picture) {
+        for (int c = 0; c < SHIELD_WIDTH; c++) {
+            *mask |= ((1ULL << SHIELD_HEIGHT) - 1) << (c * SHIELD_COLUMN_BITS);
+        }
+        return true;
+    }
+    
+    for (const char *p = picture; *p; p++) {
+        if (*p == '/') {
+            row++;
+            col = 0;
+            continue;
+        }
+        if (row >= SHIELD_HEIGHT || col >= SHIELD_WIDTH) return false;
+        if (*p == 'o') *mask |= 1ULL << (col * SHIELD_COLUMN_BITS + row);
+        col++;
+    }
+    return true;
+}
+
+/**
+ * Build the pack
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s INPUT.txt OUTPUT.pack\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *in_path = argv[1];
+    const char *out_path = argv[2];
+    
+    FILE *in = fopen(in_path, "r");
+    if (!in) {
+        fprintf(stderr, "levelpack: cannot open %s\n", in_path);
+        return EXIT_FAILURE;
+    }
+    
+    LevelPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEVEL_PACK_MAGIC, 4);
+    header.version = LEVEL_PACK_VERSION;
+    
+    int count = 0, rows = 0;
+    int width = 0, height = 0, cols = 0, pitch_x = 0, pitch_y = 0;
+    PackLevel *level = NULL;
+    LevelRecord current = {ENEMY_START_X, ENEMY_START_Y, ENEMY_MOVE_PERIOD, ENEMY_FIRE_RATE,
+                           ENEMY_PROJECTILE_SPEED, 0, 0};
+    char text[256];
+    int line = 0;
+    
+    while (fgets(text, sizeof(text), in)) {
+        line++;
+        char *hash = strchr(text, '#');
+        if (hash) *hash = '\0';
+    
+        char word[16], arg[PACK_MAX_COLS + 2];
+        int a, b;
+        if (sscanf(text, "%15s", word) != 1) continue;
+    
+        if (strcmp(word, "board") == 0 && sscanf(text, "%*s %d %d", &width, &height) == 2) {
+            continue;
+        }
+        if (strcmp(word, "formation") == 0 &&
+            sscanf(text, "%*s %d %d %d", &cols, &pitch_x, &pitch_y) == 3) {
+            if (cols < 1 || cols > PACK_MAX_COLS) return parse_error(in_path, line, "bad column count");
+            continue;
+        }
+        if (strcmp(word, "level") == 0) {
+            if (count == PACK_MAX_LEVELS) return parse_error(in_path, line, "too many levels");
+            level = &levels[count++];
+            level->record = current;
+            if (count > 1) {
+                /* Shields carry over until the level lists its own */
+                level->shield_count = levels[count - 2].shield_count;
+                memcpy(level->shields, levels[count - 2].shields, sizeof(level->shields));
+            }
+            continue;
+        }
+        if (!level) return parse_error(in_path, line, "expected board, formation or level");
+    
+        if (strcmp(word, "period") == 0 && sscanf(text, "%*s %d", &a) == 1) {
+            level->record.move_period = (uint16_t)a;
+        } else if (strcmp(word, "fire") == 0 && sscanf(text, "%*s %d", &a) == 1) {
+            level->record.fire_period = (uint16_t)a;
+        } else if (strcmp(word, "shot") == 0 && sscanf(text, "%*s %d", &a) == 1) {
+            level->record.shot_speed = (uint16_t)a;
+        } else if (strcmp(word, "aim") == 0 && sscanf(text, "%*s %d", &a) == 1) {
+            level->record.aim_chance = (uint16_t)a;
+        } else if (strcmp(word, "origin") == 0 && sscanf(text, "%*s %d %d", &a, &b) == 2) {
+            level->record.origin_x = (int16_t)a;
+            level->record.origin_y = (int16_t)b;
+        } else if (strcmp(word, "row") == 0 && sscanf(text, "%*s %65s", arg) == 1) {
+            if (level->row_count == PACK_MAX_ROWS || (int)strlen(arg) != cols) {
+                return parse_error(in_path, line, "row must have one character per formation column");
+            }
+            strcpy(level->rows[level->row_count++], arg);
+            if (level->row_count > rows) rows = level->row_count;
+        } else if (strcmp(word, "shield") == 0 && sscanf(text, "%*s %d %d", &a, &b) == 2) {
+            /* The first shield line of a level replaces the inherited set */
+            if (!level->shields_given) {
+                level->shields_given = true;
+                level->shield_count = 0;
+            }
+            if (level->shield_count == PACK_MAX_SHIELDS) return parse_error(in_path, line, "too many shields");
+            LevelShield *shield = &level->shields[level->shield_count++];
+            memset(shield, 0, sizeof(*shield));
+            shield->x = (int16_t)a;
+            shield->y = (int16_t)b;
+            arg[0] = '\0';
+            sscanf(text, "%*s %*d %*d %65s", arg);
+            if (!shield_mask(arg, &shield->mask)) {
+                return parse_error(in_path, line, "shield pattern larger than a shield");
+            }
+        } else {
+            return parse_error(in_path, line, "unknown or malformed directive");
+        }
+        current = level->record;
+    }
+    fclose(in);
+    
+    if (count == 0 || width <= 0 || height <= 0 || cols == 0 || rows == 0) {
+        fprintf(stderr, "levelpack: %s needs board, formation and at least one level with rows\n", in_path);
+        return EXIT_FAILURE;
+    }
+    
+    int enemy_count = rows * cols;
+    int words = (enemy_count + 63) / 64;
+    int shields = levels[0].shield_count;
+    header.level_count = (uint16_t)count;
+    header.board_width = (uint16_t)width;
+    header.board_height = (uint16_t)height;
+    header.enemy_count = (uint32_t)enemy_count;
+    header.enemy_cols = (uint16_t)cols;
+    header.enemy_spacing_x = (uint16_t)pitch_x;
+    header.enemy_spacing_y = (uint16_t)pitch_y;
+    header.shield_count = (uint16_t)shields;
+    header.record_size = (uint32_t)level_pack_record_size(enemy_count, shields);
+    
+    size_t records_size = (size_t)count * header.record_size;
+    unsigned char *records = calloc(1, records_size);
+    if (!records) return EXIT_FAILURE;
+    
+    for (int i = 0; i < count; i++) {
+        PackLevel *l = &levels[i];
+        if (l->shield_count != shields) {
+            fprintf(stderr, "levelpack: level %d has %d shields, level 1 has %d\n",
+                    i + 1, l->shield_count, shields);
+            return EXIT_FAILURE;
+        }
+    
+        unsigned char *at = records + (size_t)i * header.record_size;
+        LevelRecord record = l->record;
+        uint64_t *mask = (uint64_t *)(at + sizeof(LevelRecord));
+        record.alive = 0;
+        for (int r = 0; r < l->row_count; r++) {
+            for (int c = 0; c < cols; c++) {
+                if (l->rows[r][c] == 'o') {
+                    int slot = r * cols + c;
+                    mask[slot / 64] |= 1ULL << (slot % 64);
+                    record.alive++;
+                }
+            }
+        }
+        memcpy(at, &record, sizeof(record));
+        memcpy(at + sizeof(LevelRecord) + (size_t)words * sizeof(uint64_t), l->shields,
+               (size_t)shields * sizeof(LevelShield));
+    }
+    header.checksum = level_pack_checksum(records, records_size);
+    
+    FILE *out = fopen(out_path, "wb");
+    if (!out || fwrite(&header, sizeof(header), 1, out) != 1 ||
+        fwrite(records, 1, records_size, out) != records_size || fclose(out) != 0) {
+        fprintf(stderr, "levelpack: cannot write %s\n", out_path);
+        free(records);
+        return EXIT_FAILURE;
+    }
+    free(records);
+    
+    /* Validate the result exactly as the game will */
+    LevelPack *pack = level_pack_open(out_path);
+    if (!pack) {
+        remove(out_path);
+        return EXIT_FAILURE;
+    }
+    printf("levelpack: %s: %d levels, %dx%d formation, %d shields, %u bytes per level, checksum %08x\n",
+           out_path, count, rows, cols, shields, (unsigned)header.record_size, (unsigned)header.checksum);
+    level_pack_close(pack);
+    return EXIT_SUCCESS;
+}